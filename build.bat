@@ -9,12 +9,17 @@ if not "%release%"=="1" set debug=1
 
 :: command types
 set compiler_libs=-Lvendor/raylib/src/ -lraylib -lmsvcrt -lraylib -lOpenGL32 -lGdi32 -lWinMM -lkernel32 -lshell32 -lUser32 -Xlinker /NODEFAULTLIB:libcmt
-set compiler_common=-std=c23 -Wall -Wextra -Wpedantic -Wno-missing-braces -Wno-unused-function -Wno-unused-value -Wno-unused-variable -Wno-unused-local-typedef -Wno-unused-but-set-variable -Wno-initializer-overrides
+set compiler_common=-std=c23 -Wall -Wextra -Wpedantic -Wno-missing-braces -Wno-unused-function -Wno-unused-value -Wno-unused-variable -Wno-unused-local-typedef -Wno-unused-but-set-variable -Wno-initializer-overrides -ffp-contract=off
 set compiler_debug=call clang -g -O0 -DBUILD_DEBUG=1 %compiler_common%
 set compiler_release=call clang -O2 -DBUILD_DEBUG=0 %compiler_common%
 
 if "%debug%"=="1" set compiler=%compiler_debug%
 if "%release%"=="1" set compiler=%compiler_release%
+:: avx2: build the 8 wide paths of the batch and motion kernels, the binary then needs an AVX2 cpu
+if "%avx2%"=="1" set compiler=%compiler% -mavx2
 
 :: compile
-%compiler% orthography.c %compiler_libs% -o orthography.exe
\ No newline at end of file
+%compiler% orthography.c %compiler_libs% -o orthography.exe
+
+:: assets
+if "%pak%"=="1" orthography.exe --pak
@@ -6,13 +6,26 @@ for arg in "$@"; do declare $arg='1'; done
 if [ ! -v release ]; then debug=1; fi
 
 # command types
-compiler_libs='-Lvendor/raylib/src/ -lraylib -lm'
-compiler_common='-std=c23 -Wall -Wextra -Wpedantic -Wno-missing-braces -Wno-unused-function -Wno-unused-value -Wno-unused-variable -Wno-unused-local-typedef -Wno-unused-but-set-variable -Wno-initializer-overrides'
+compiler_libs='-Lvendor/raylib/src/ -lraylib -lm -lpthread'
+compiler_common='-std=c23 -Wall -Wextra -Wpedantic -Wno-missing-braces -Wno-unused-function -Wno-unused-value -Wno-unused-variable -Wno-unused-local-typedef -Wno-unused-but-set-variable -Wno-initializer-overrides -ffp-contract=off'
 compiler_debug="clang -O0 -g -DBUILD_DEBUG=1 $compiler_common"
 compiler_release="clang -O2 -Werror -DBUILD_DEBUG=0 $compiler_common"
 
 if [ -v debug ]; then compiler="$compiler_debug"; fi
 if [ -v release ]; then compiler="$compiler_release"; fi
+# avx2: build the 8 wide paths of the batch and motion kernels, the binary then needs an AVX2 cpu
+if [ -v avx2 ]; then compiler="$compiler -mavx2"; fi
 
 # compile
-$compiler orthography.c $compiler_libs -o orthography
+# hot: the game is a shared library the running executable reloads when it changes
+# game: only rebuild that library
+if [ -v hot ]; then
+    $compiler -DBUILD_HOT_RELOAD=1 -fPIC -shared orthography_game.c -o orthography_game.so.tmp
+    mv orthography_game.so.tmp orthography_game.so # swap in one step so a half written library is never loaded
+    if [ ! -v game ]; then $compiler -DBUILD_HOT_RELOAD=1 orthography.c $compiler_libs -ldl -rdynamic -o orthography; fi
+else
+    $compiler orthography.c $compiler_libs -o orthography
+fi
+
+# assets
+if [ -v pak ]; then ./orthography --pak; fi
@@ -1,5 +1,4 @@
-#include "orthography.h"
-#include <stdlib.h>
+#include "orthography_game.h"
 
 //~ acadia: GameState
 typedef enum : U64
@@ -8,793 +7,3321 @@ typedef enum : U64
     GameState_Playing,
 } GameState;
 
-//~ angn: EventType
-typedef enum : U64
+//~ angn: Game code
+// angn: hot reload builds load the game from a shared library, otherwise it is
+// part of this translation unit like everything else
+#if !BUILD_HOT_RELOAD
+#include "orthography_game.c"
+#endif
+
+//~ angn: Render snapshot
+// angn: immutable copy of what the renderer needs from one tick, the
+// simulation thread fills one while the main thread draws another
+typedef struct RenderEntity RenderEntity;
+struct RenderEntity
 {
-    EventType_Shoot, // angn: i have no idea what we want
-    EventType__Count,
-} EventType;
-
-//~ daria: Render/Animation
-#define MAX_ANIMATIONS 1
-#define ANIMATION_CAPACITY 5
+    EntityFlags flags;
 
-//~ daria: Audio
-#define SOUND_EFFECT_CAPACITY 5 // used in Entity
+    //- angn: transform
+    Vector2 prev_position;
+    Vector2 position;
+    F32 prev_rotation;
+    F32 rotation;
 
-#define SOUNDS_LIST \
-    SOUNDS_LIST_X(CatMeow, "audio/Cat_Meow.wav") \
+    //- daria: animation frame
+    TextureName texture;
+    U64 sprite_map_index;
+    U32 cell_size;
+};
 
-typedef enum : U32
+typedef struct RenderSnapshot RenderSnapshot;
+struct RenderSnapshot
 {
-#define SOUNDS_LIST_X(n, path) SoundName_##n,
-    SOUNDS_LIST
-#undef SOUNDS_LIST_X
-    SoundName__Count,
-} SoundName;
+    U64 tick;
+    U64 tick_time_us; // angn: wall time the current transforms belong to
 
-char *sound_names[] =
-{
-#define SOUNDS_LIST_X(n, path) path,
-    SOUNDS_LIST
-#undef SOUNDS_LIST_X
+    RenderEntity entities[ENTITIES_CAPACITY];
+    U64 entities_count;
 };
 
-//~ daria: Animations
-// daria: TODO: place this elsewhere
-typedef struct AnimationFrame AnimationFrame;
-struct AnimationFrame
+// angn: triple buffer, the simulation and renderer never wait on each other
+#define RENDER_SNAPSHOT_NEW_BIT (1ull << 63)
+
+typedef struct RenderSnapshotBuffer RenderSnapshotBuffer;
+struct RenderSnapshotBuffer
 {
-    U64 sprite_map_index; // starting frame index
-    U32 duration; // per frame
+    RenderSnapshot snapshots[3];
+    U64 back;    // angn: owned by the simulation thread
+    U64 present; // angn: shared, only touched atomically
+    U64 front;   // angn: owned by the main thread
 };
 
-typedef struct Animation Animation;
-struct Animation
+internal void
+render_snapshot_buffer_init(
+        RenderSnapshotBuffer *buffer)
+{
+    buffer->back = 0;
+    buffer->present = 1;
+    buffer->front = 2;
+}
+
+internal RenderSnapshot *
+render_snapshot_begin(
+        RenderSnapshotBuffer *buffer)
+{
+    return(&buffer->snapshots[buffer->back]);
+}
+
+internal void
+render_snapshot_publish(
+        RenderSnapshotBuffer *buffer)
+{
+    buffer->back = AtomicExchangeU64(&buffer->present, buffer->back | RENDER_SNAPSHOT_NEW_BIT) & ~RENDER_SNAPSHOT_NEW_BIT;
+}
+
+internal RenderSnapshot *
+render_snapshot_acquire(
+        RenderSnapshotBuffer *buffer)
+{
+    if(AtomicLoadU64(&buffer->present) & RENDER_SNAPSHOT_NEW_BIT)
+    {
+        buffer->front = AtomicExchangeU64(&buffer->present, buffer->front) & ~RENDER_SNAPSHOT_NEW_BIT;
+    }
+    return(&buffer->snapshots[buffer->front]);
+}
+
+internal void
+render_snapshot_fill(
+        RenderSnapshot *snapshot,
+        Game *game,
+        U64 tick,
+        U64 tick_time_us)
 {
-    Texture2D texture;
+    snapshot->tick = tick;
+    snapshot->tick_time_us = tick_time_us;
+    snapshot->entities_count = 0;
 
-    U32 x_cell_count;
-    U32 y_cell_count;
+    for(U64 ei = 0;
+            ei < ENTITIES_CAPACITY;
+            ei += 1)
+    {
+        Entity *entity = &game->entities[ei];
+        if(!entity_flags_contains(&entity->flags, EntityFlagsIndex_Alive))
+        {
+            continue;
+        }
+
+        RenderEntity *render = &snapshot->entities[snapshot->entities_count];
+        snapshot->entities_count += 1;
+
+        render->flags = entity->flags;
+        render->prev_position = entity->prev_position;
+        render->position = entity->position;
+        render->prev_rotation = entity->spell_data.prev_rotation;
+        render->rotation = entity->spell_data.rotation;
+
+        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_RenderTexture))
+        {
+            Animation *animation = &entity->animations[entity->player_state];
+            render->texture = animation->texture;
+            render->sprite_map_index = animation->frames[animation->current_frame].sprite_map_index;
+            render->cell_size = animation->cell_size;
+        }
+    }
+}
+
+//~ angn: Render culling
+#define RENDER_SPRITE_SIZE 128.0f  // px, on screen size of a textured entity
+#define RENDER_SPELL_RADIUS 25.0f  // px
+#define RENDER_CULL_MARGIN 32.0f   // px past the screen edge that still counts as visible
 
-    AnimationFrame *frames;
-    // left to right, top to bottom
-    U32 frames_size;
-    U32 current_frame;
-    U32 frame_duration;
-    U32 cell_size; // px
+typedef struct RenderVisibleList RenderVisibleList;
+struct RenderVisibleList
+{
+    U32 *indices; // angn: into RenderSnapshot::entities
+    U64 count;
+    U64 culled_count;
 };
 
-internal Animation
-animation_load(
+internal Rectangle
+render_view_from_screen(
+        Vec2S32 screen,
+        F32 margin)
+    // angn: NOTE: there is no camera yet, the view is the screen
+{
+    return((Rectangle)
+            {
+                -margin,
+                -margin,
+                Cast(F32, screen.x) + 2.0f * margin,
+                Cast(F32, screen.y) + 2.0f * margin,
+            });
+}
+
+internal Rectangle
+render_entity_bounds(
+        RenderEntity *entity,
+        Vector2 render_position)
+{
+    Rectangle bounds = {0};
+    if(entity_flags_contains(&entity->flags, EntityFlagsIndex_RenderTexture))
+    {
+        // angn: matches the destination rectangle and origin used when drawing
+        bounds = (Rectangle)
+        {
+            render_position.x - entity->cell_size,
+            render_position.y - entity->cell_size,
+            RENDER_SPRITE_SIZE,
+            RENDER_SPRITE_SIZE,
+        };
+    }
+    else
+    {
+        bounds = (Rectangle)
+        {
+            render_position.x - RENDER_SPELL_RADIUS,
+            render_position.y - RENDER_SPELL_RADIUS,
+            2.0f * RENDER_SPELL_RADIUS,
+            2.0f * RENDER_SPELL_RADIUS,
+        };
+    }
+    return(bounds);
+}
+
+internal RenderVisibleList
+render_snapshot_query_visible(
         Arena *arena,
-        Texture2D texture,
-        U8 frames_size,
-        U8 cell_size)
-{
-    // Animation
-    Animation a =
-    {
-        .texture = texture,
-        .x_cell_count = Cast(F32, a.texture.width) / cell_size,
-        .y_cell_count = Cast(F32, a.texture.height) / cell_size,
-        .frames = arena_push_array(arena, AnimationFrame, frames_size),
-        .frames_size = frames_size,
-        .cell_size = cell_size
-    };
+        RenderSnapshot *snapshot,
+        Rectangle view,
+        F32 render_alpha)
+{
+    RenderVisibleList list = {0};
+    list.indices = arena_push_array_no_zero(arena, U32, snapshot->entities_count);
+
+    for(U64 ri = 0;
+            ri < snapshot->entities_count;
+            ri += 1)
+    {
+        RenderEntity *entity = &snapshot->entities[ri];
+        Vector2 render_position = Vector2Lerp(entity->prev_position, entity->position, render_alpha);
+        if(CheckCollisionRecs(render_entity_bounds(entity, render_position), view))
+        {
+            list.indices[list.count] = Cast(U32, ri);
+            list.count += 1;
+        }
+        else
+        {
+            list.culled_count += 1;
+        }
+    }
 
-    return a;
+    return(list);
 }
 
-internal void
-animation_next_frame(
-        Animation *a)
-{
-    if(a->frame_duration >= a->frames[a->current_frame].duration)
-    {
-        a->current_frame = (a->current_frame + 1) % a->frames_size;
-    }
-}
-
-//~ angn: Inputs
-typedef enum InputState : U8
-{
-    InputState_Down = (1<<0),
-    InputState_Up = (1<<1),
-    InputState_Pressed = (1<<2),
-    InputState_Released = (1<<3),
-} InputState;
-
-typedef enum InputTypes : U64
-{
-    InputTypes_W,
-    InputTypes_A,
-    InputTypes_S,
-    InputTypes_D,
-    InputTypes_Select_Spell_0,
-    InputTypes_Select_Spell_1,
-    InputTypes_Select_Spell_2,
-    InputTypes_Shoot,
-    InputTypes__Count,
-} InputTypes;
-
-typedef InputState Inputs[InputTypes__Count];
-typedef KeyboardKey KeyMap[InputTypes__Count];
-
-//~ nick: Spells
-#define SPELL_SLOTS_MAX 16
-#define SPELL_PROGRAMS_MAX 8
-
-typedef enum : U8 {
-    SpellType_Bomb,
-    SpellType_Bolt,
-    SpellType_Loop_Bolt,
-    SpellType_Bounce_Bolt,
-    SpellType__Count,
-} SpellType;
-
-typedef enum : U8 {
-    //- nick: movement spells
-    SpellInstruction_Accel_Forward,
-    SpellInstruction_Accel_Left,
-    SpellInstruction_Accel_Right,
-    SpellInstruction_Accel_Back,
-    SpellInstruction_Turn_Left,
-    SpellInstruction_Turn_Right,
-    SpellInstruction_Turn_About,
-    SpellInstruction_Face_Enemy,
-    SpellInstruction_Face_Player,
-    SpellInstruction_Abeam_Enemy,
-    SpellInstruction_Abeam_Player,
-
-    //- nick: utility spells
-    SpellInstruction_Duplicate,
-    SpellInstruction_Death_Duplicate,
-    SpellInstruction_Burst_Duplicate,
-    SpellInstruction_Increase_Lifetime,
-    SpellInstruction_Decrease_Lifetime,
-    SpellInstruction_Destroy_Spell,
-    SpellInstruction_Increase_Execution_Speed,
-    SpellInstruction_Decrease_Execution_Speed,
-    SpellInstruction_Loop,
-
-    //- nick: effect spells
-    SpellInstruction_Arm_Pierce,
-    SpellInstruction_Arm_Explode,
-    SpellInstruction_Do_Sear,
-    SpellInstruction_Do_Flameburst,
-
-    SpellInstruction__Count,
-} SpellInstruction;
-
-typedef struct SpellData SpellData;
-struct SpellData {
-    SpellType type;     // nick: projectile type
-    U8 program_index;   // nick: which spell program are we following
-    U8 program_length;  // nick: number of instruction slots used
-    U8 slot_index;      // nick: which slot we're on
-    U8 lifetime;        // nick: remaining lifetime in steps
-    U8 tick;            // nick: increments each update
-    U8 ticks_per_step;  // nick: step period in ticks
-    F32 rotation;
-};
+//~ angn: Text cache
+// angn: strings drawn every frame are rasterized once into a texture and then
+// cost one quad, keyed by the text, font, size and spacing
+// angn: NOTE: textures are made and freed here, main thread only
+#define TEXT_CACHE_CAPACITY 64
+#define TEXT_CACHE_TEXT_MAX 64 // angn: longer strings are drawn directly
 
-//~ angn: Handle
-typedef struct Handle Handle;
-struct Handle
+typedef struct TextCacheEntry TextCacheEntry;
+struct TextCacheEntry
 {
-    U64 index;
-    U64 gen;
+    U64 hash; // angn: 0 is a free slot
+    U64 last_used;
+    U32 font_id;
+    F32 font_size;
+    F32 spacing;
+    U8 text[TEXT_CACHE_TEXT_MAX]; // angn: null terminated for raylib
+    U64 text_size;
+    Vector2 measure;
+    RenderTexture2D target;
 };
 
-//~ angn: EntityFlags
-typedef struct EntityFlags EntityFlags;
-struct EntityFlags
+typedef struct TextCache TextCache;
+struct TextCache
 {
-    U64 f[1];
+    TextCacheEntry entries[TEXT_CACHE_CAPACITY];
+    U64 uses;
 };
 
-typedef enum : U64
+internal U64
+text_cache_hash(
+        U32 font_id,
+        F32 font_size,
+        F32 spacing,
+        String8 text)
 {
-    EntityFlagsIndex_Alive,
-    EntityFlagsIndex_ApplyVelocity,
-    EntityFlagsIndex_WASDMotion,
-    EntityFlagsIndex_Collider,
-    EntityFlagsIndex_Trigger,
-    EntityFlagsIndex_ApplyFriction,
-    EntityFlagsIndex_ApplyBounce,
-    EntityFlagsIndex_ShootOnClick,
-    EntityFlagsIndex_Player,
-    EntityFlagsIndex_RenderTexture,
-    EntityFlagsIndex_Spell,
-    EntityFlagsIndex__Count,
-} EntityFlagsIndex;
-
-#define EntityFlags_Assert_IndexValid(index) do { \
-    Assert(index < EntityFlagsIndex__Count); \
-    U64 max_number_of_bits = sizeof(MemberOf(EntityFlags, f)) * 8; \
-    Assert(index < max_number_of_bits); \
-} while(0)
+    U32 size_bits = 0;
+    U32 spacing_bits = 0;
+    memcpy(&size_bits, &font_size, sizeof(size_bits));
+    memcpy(&spacing_bits, &spacing, sizeof(spacing_bits));
+    U64 seed = hash_u64(U64FromTwoU32s(size_bits, spacing_bits) ^ hash_u64(font_id));
+    return(hash_u64_from_bytes(text.string, text.size, seed) | 1); // angn: never 0
+}
 
-internal void
-entity_flags_set(
-        EntityFlags *flags,
-        EntityFlagsIndex index)
+// angn: returns 0 when the text is too long to cache
+internal TextCacheEntry *
+text_cache_get(
+        TextCache *cache,
+        Font font,
+        String8 text,
+        F32 font_size,
+        F32 spacing)
 {
-    EntityFlags_Assert_IndexValid(index);
-    U64 number_of_bits_in_cell = sizeof(*MemberOf(EntityFlags, f)) * 8;
-    U64 quo = index / number_of_bits_in_cell;
-    U64 rem = index % number_of_bits_in_cell;
-    flags->f[quo] |= (1 << rem);
+    if(text.size >= TEXT_CACHE_TEXT_MAX)
+    {
+        return(0);
+    }
+
+    cache->uses += 1;
+    U64 hash = text_cache_hash(font.texture.id, font_size, spacing, text);
+    TextCacheEntry *victim = &cache->entries[0];
+    for(U64 ei = 0;
+            ei < TEXT_CACHE_CAPACITY;
+            ei += 1)
+    {
+        TextCacheEntry *entry = &cache->entries[ei];
+        if(entry->hash == hash &&
+                entry->font_id == font.texture.id &&
+                entry->font_size == font_size &&
+                entry->spacing == spacing &&
+                entry->text_size == text.size &&
+                memcmp(entry->text, text.string, text.size) == 0)
+        {
+            entry->last_used = cache->uses;
+            return(entry);
+        }
+        if(victim->hash != 0 && (entry->hash == 0 || entry->last_used < victim->last_used))
+        {
+            victim = entry;
+        }
+    }
+
+    //- angn: miss, rasterize over the least recently used slot
+    if(victim->hash != 0)
+    {
+        UnloadRenderTexture(victim->target);
+    }
+    TextCacheEntry *entry = victim;
+    entry->hash = hash;
+    entry->last_used = cache->uses;
+    entry->font_id = font.texture.id;
+    entry->font_size = font_size;
+    entry->spacing = spacing;
+    memcpy(entry->text, text.string, text.size);
+    entry->text[text.size] = 0;
+    entry->text_size = text.size;
+    entry->measure = MeasureTextEx(font, (char *)entry->text, font_size, spacing);
+    entry->target = LoadRenderTexture(Cast(int, ceilf(entry->measure.x)), Cast(int, ceilf(entry->measure.y)));
+
+    // angn: drawn white so the tint picks the color
+    BeginTextureMode(entry->target);
+    ClearBackground(BLANK);
+    DrawTextEx(font, (char *)entry->text, (Vector2){0}, font_size, spacing, WHITE);
+    EndTextureMode();
+    return(entry);
 }
 
-internal void
-entity_flags_unset(
-        EntityFlags *flags,
-        EntityFlagsIndex index)
+internal Vector2
+text_cache_measure(
+        TextCache *cache,
+        Font font,
+        String8 text,
+        F32 font_size,
+        F32 spacing)
 {
-    EntityFlags_Assert_IndexValid(index);
-    U64 number_of_bits_in_cell = sizeof(*MemberOf(EntityFlags, f)) * 8;
-    U64 quo = index / number_of_bits_in_cell;
-    U64 rem = index % number_of_bits_in_cell;
-    flags->f[quo] &= ~(1 << rem);
+    Vector2 measure = {0};
+    TextCacheEntry *entry = text_cache_get(cache, font, text, font_size, spacing);
+    if(entry)
+    {
+        measure = entry->measure;
+    }
+    else
+    {
+        measure = MeasureTextEx(font, (char *)text.string, font_size, spacing);
+    }
+    return(measure);
 }
 
-internal B32
-entity_flags_contains(
-        EntityFlags *flags,
-        EntityFlagsIndex index)
+// angn: NOTE: text must be null terminated for the uncached fallback
+internal void
+text_cache_draw(
+        TextCache *cache,
+        Font font,
+        String8 text,
+        Vector2 position,
+        F32 font_size,
+        F32 spacing,
+        Color tint)
 {
-    EntityFlags_Assert_IndexValid(index);
-    U64 number_of_bits_in_cell = sizeof(*MemberOf(EntityFlags, f)) * 8;
-    U64 quo = index / number_of_bits_in_cell;
-    U64 rem = index % number_of_bits_in_cell;
-    return(flags->f[quo] & (1 << rem));
+    TextCacheEntry *entry = text_cache_get(cache, font, text, font_size, spacing);
+    if(entry)
+    {
+        // angn: render textures come out upside down
+        Rectangle source = { 0, 0, Cast(F32, entry->target.texture.width), -Cast(F32, entry->target.texture.height) };
+        DrawTextureRec(entry->target.texture, source, position, tint);
+    }
+    else
+    {
+        DrawTextEx(font, (char *)text.string, position, font_size, spacing, tint);
+    }
 }
 
-//~ daria: entity states
-typedef U64 EntityState;
-typedef enum : EntityState
+internal void
+text_cache_release(
+        TextCache *cache)
 {
-    PlayerState_Idle,
-    PlayerState_Down,
-    PlayerState_Up,
-    PlayerState_Left,
-    PlayerState_Right,
-} PlayerState;
+    for(U64 ei = 0;
+            ei < TEXT_CACHE_CAPACITY;
+            ei += 1)
+    {
+        if(cache->entries[ei].hash != 0)
+        {
+            UnloadRenderTexture(cache->entries[ei].target);
+        }
+    }
+    memset(cache, 0, sizeof(*cache));
+}
+
+//~ angn: SPSC queue
+// angn: single producer, single consumer ring, lock free because the producer
+// only writes write_pos and the consumer only read_pos.
+// SpscQueueDefine(InputQueue, input_queue, InputEvent, 256) gives the
+// InputQueue type and input_queue_push, input_queue_peek and input_queue_pop
+#define SpscQueueDefine(Name,name,T,capacity) \
+    StaticAssert(((capacity) & ((capacity) - 1)) == 0, name##_capacity_is_pow2); \
+    typedef struct Name Name; \
+    struct Name \
+    { \
+        T events[(capacity)]; \
+        U64 write_pos; \
+        U64 read_pos; \
+    }; \
+    internal B32 name##_push(Name *queue, T event) \
+    { \
+        B32 pushed = 0; \
+        U64 write_pos = queue->write_pos; \
+        U64 read_pos = AtomicLoadU64(&queue->read_pos); \
+        if(write_pos - read_pos < (capacity)) \
+        { \
+            queue->events[write_pos & ((capacity) - 1)] = event; \
+            AtomicStoreU64(&queue->write_pos, write_pos + 1); \
+            pushed = 1; \
+        } \
+        return(pushed); \
+    } \
+    internal B32 name##_peek(Name *queue, T *event) \
+    { \
+        B32 peeked = 0; \
+        U64 read_pos = queue->read_pos; \
+        U64 write_pos = AtomicLoadU64(&queue->write_pos); \
+        if(read_pos != write_pos) \
+        { \
+            *event = queue->events[read_pos & ((capacity) - 1)]; \
+            peeked = 1; \
+        } \
+        return(peeked); \
+    } \
+    internal B32 name##_pop(Name *queue, T *event) \
+    { \
+        B32 popped = name##_peek(queue, event); \
+        if(popped) { AtomicStoreU64(&queue->read_pos, queue->read_pos + 1); } \
+        return(popped); \
+    }
 
-//~ angn: Entities
-typedef struct Entity Entity;
-struct Entity
+//~ angn: Input queue
+// angn: main thread to simulation thread
+// angn: NOTE: events are edges, each tick only takes the ones that happened
+// before its simulated time, so presses land in the tick they belong to
+typedef struct InputEvent InputEvent;
+struct InputEvent
 {
-    EntityFlags flags;
-    Handle handle;
+    U64 time_us; // angn: os_now_microseconds clock
+    InputTypes type;
+    InputState state;
+};
 
-    //- angn: state
-    EntityState player_state;
+#define INPUT_QUEUE_CAPACITY 256
+SpscQueueDefine(InputQueue, input_queue, InputEvent, INPUT_QUEUE_CAPACITY)
 
-    //- angn: motion
-    Vector2 position;
-    Vector2 velocity;
-    F32 friction;
-    Rectangle collision;
+//~ angn: Sound event queue
+// angn: simulation thread to main thread
+#define SOUND_EVENT_QUEUE_CAPACITY 256
+SpscQueueDefine(SoundEventQueue, sound_event_queue, SoundEvent, SOUND_EVENT_QUEUE_CAPACITY)
 
-    //- nick: spells
-    SpellData spell_data;
+//~ angn: Audio voices
+// angn: a fixed set of aliases per sound, shared by every entity
+#define AUDIO_VOICES_PER_SOUND 8
 
-    //- angn: audio
-    Sound sound_effects[EventType__Count];
+typedef struct AudioEventParams AudioEventParams;
+struct AudioEventParams
+{
+    U32 max_voices; // angn: concurrent instances of this event
+    U8 priority;    // angn: higher steals from lower
+};
 
-    //- angn: TODO: render / animations
-    Animation animations[ANIMATION_CAPACITY];
+global AudioEventParams audio_event_params[EventType__Count] =
+{
+    [EventType_Shoot] = { .max_voices = 4, .priority = 1 },
+    [EventType_Explode] = { .max_voices = 4, .priority = 2 },
 };
 
-//~ nick: Physics
-#define COLLISIONS_MAX 128
+typedef struct AudioVoice AudioVoice;
+struct AudioVoice
+{
+    Sound alias;
+    EventType event;
+    U8 priority;
+    F32 distance; // angn: from the listener when it started
+    U64 start_frame;
+};
 
-//~ angn: Game
-#define ENTITIES_CAPACITY 4096
+typedef struct AudioVoicePool AudioVoicePool;
+struct AudioVoicePool
+{
+    B32 loaded[SoundName__Count];
+    Sound sources[SoundName__Count];
+    AudioVoice voices[SoundName__Count][AUDIO_VOICES_PER_SOUND];
+    Vector2 listener;
+    U64 frame;
+};
 
-typedef struct Game Game;
-struct Game
+internal void
+audio_voice_pool_set_source(
+        AudioVoicePool *pool,
+        SoundName name,
+        Sound source)
+    // angn: NOTE: replacing a loaded source cuts off whatever it was playing
 {
-    Vec2S32 screen;
+    if(pool->loaded[name])
+    {
+        for(U64 vi = 0;
+                vi < AUDIO_VOICES_PER_SOUND;
+                vi += 1)
+        {
+            StopSound(pool->voices[name][vi].alias);
+            UnloadSoundAlias(pool->voices[name][vi].alias);
+        }
+        UnloadSound(pool->sources[name]);
+    }
 
-    Entity entities[ENTITIES_CAPACITY];
-    U64 entities_count;
+    pool->sources[name] = source;
+    for(U64 vi = 0;
+            vi < AUDIO_VOICES_PER_SOUND;
+            vi += 1)
+    {
+        pool->voices[name][vi].alias = LoadSoundAlias(source);
+    }
+    pool->loaded[name] = 1;
+}
 
-    SpellInstruction spell_programs[SPELL_PROGRAMS_MAX][SPELL_SLOTS_MAX];
-    SpellType spell_type_rand[3];
-    SpellInstruction spell_instruction_rand[3];
-    _Bool new_spell;
-    SpellData spell_construction;
+internal void
+audio_voice_pool_release(
+        AudioVoicePool *pool)
+{
+    for(U64 si = 0;
+            si < SoundName__Count;
+            si += 1)
+    {
+        if(!pool->loaded[si])
+        {
+            continue;
+        }
 
-    Sound sound_effects[SoundName__Count];
-};
+        for(U64 vi = 0;
+                vi < AUDIO_VOICES_PER_SOUND;
+                vi += 1)
+        {
+            UnloadSoundAlias(pool->voices[si][vi].alias);
+        }
+        UnloadSound(pool->sources[si]);
+    }
+}
 
-internal Entity *
-get_entity_from_handle(
-        Game *game,
-        Handle handle)
+internal B32
+audio_voice_steal_before(
+        AudioVoice *a,
+        AudioVoice *b)
+    // angn: lower priority goes first, then whatever is further away, then the oldest
 {
-    Assert(handle.index < ENTITIES_CAPACITY);
-    Entity *entity = &game->entities[handle.index];
-    if(entity->handle.gen != handle.gen) { entity = 0; }
-    return(entity);
+    B32 result = 0;
+    if(a->priority != b->priority) { result = a->priority < b->priority; }
+    else if(a->distance != b->distance) { result = a->distance > b->distance; }
+    else { result = a->start_frame < b->start_frame; }
+    return(result);
 }
 
-internal Entity *
-alloc_entity(
-        Game *game)
-    // angn: SUGGEST: should we allow for bulk allocations?
+internal B32
+audio_voice_can_steal(
+        U8 priority,
+        F32 distance,
+        AudioVoice *victim)
 {
-    Entity *entity = 0;
+    B32 result = 0;
+    if(priority != victim->priority) { result = priority > victim->priority; }
+    else { result = distance <= victim->distance; }
+    return(result);
+}
 
-    if(game->entities_count + 1 >= ENTITIES_CAPACITY)
+// angn: a free voice of `name`, else the one it can steal, else 0
+internal AudioVoice *
+audio_voice_pick(
+        AudioVoicePool *pool,
+        SoundName name,
+        U8 priority,
+        F32 distance)
+{
+    AudioVoice *voice = 0;
+    AudioVoice *victim = 0;
+    for(U64 vi = 0;
+            vi < AUDIO_VOICES_PER_SOUND;
+            vi += 1)
     {
-        Assert(0 && "out of memory");
-        fprintf(stderr, "you won i guess??\n");
-        exit(-1);
+        AudioVoice *candidate = &pool->voices[name][vi];
+        if(!IsSoundPlaying(candidate->alias))
+        {
+            voice = candidate;
+            break;
+        }
+        if(victim == 0 || audio_voice_steal_before(candidate, victim))
+        {
+            victim = candidate;
+        }
     }
-    else
+
+    if(voice == 0 && victim && audio_voice_can_steal(priority, distance, victim))
     {
-        for(U64 ei = 0;
-                ei < ENTITIES_CAPACITY;
-                ei += 1)
+        voice = victim;
+    }
+    return(voice);
+}
+
+internal void
+audio_play(
+        AudioVoicePool *pool,
+        SoundEvent *sound_event)
+{
+    Assert(sound_event->name < SoundName__Count);
+    if(!pool->loaded[sound_event->name])
+    {
+        return; // angn: still streaming in
+    }
+
+    AudioEventParams *params = &audio_event_params[sound_event->event];
+    F32 distance = Vector2Distance(pool->listener, sound_event->position);
+
+    //- angn: find what is already playing for this event, across every sound
+    // and within the one we want
+    U32 event_voices = 0;
+    AudioVoice *event_victim = 0;
+    AudioVoice *own_victim = 0;
+    for(U64 si = 0;
+            si < SoundName__Count;
+            si += 1)
+    {
+        for(U64 vi = 0;
+                vi < AUDIO_VOICES_PER_SOUND;
+                vi += 1)
         {
-            if(entity_flags_contains(&game->entities[ei].flags, EntityFlagsIndex_Alive))
+            AudioVoice *voice = &pool->voices[si][vi];
+            if(!pool->loaded[si] || voice->event != sound_event->event || !IsSoundPlaying(voice->alias))
             {
                 continue;
             }
-            entity = game->entities + ei;
-            entity->handle.gen += 1;
-            game->entities_count += 1;
-            break;
+
+            event_voices += 1;
+            if(event_victim == 0 || audio_voice_steal_before(voice, event_victim))
+            {
+                event_victim = voice;
+            }
+            if(si == sound_event->name && (own_victim == 0 || audio_voice_steal_before(voice, own_victim)))
+            {
+                own_victim = voice;
+            }
         }
     }
 
-    if(entity)
+    //- angn: pick a voice
+    // angn: NOTE: a voice only ever replays its own alias, so an instance of
+    // another sound is stopped to make room, never reused
+    AudioVoice *voice = 0;
+    if(event_voices < params->max_voices)
+    {
+        voice = audio_voice_pick(pool, sound_event->name, params->priority, distance);
+    }
+    else if(own_victim)
+    {
+        if(audio_voice_can_steal(params->priority, distance, own_victim))
+        {
+            voice = own_victim;
+        }
+    }
+    else if(event_victim && audio_voice_can_steal(params->priority, distance, event_victim))
     {
-        Handle temp_handle = entity->handle;
-        memset(entity, 0, sizeof(Entity));
-        entity->handle = temp_handle;
-        entity_flags_set(&entity->flags, EntityFlagsIndex_Alive);
+        voice = audio_voice_pick(pool, sound_event->name, params->priority, distance);
+        if(voice)
+        {
+            StopSound(event_victim->alias);
+        }
     }
 
-    return(entity);
+    //- angn: play
+    if(voice)
+    {
+        StopSound(voice->alias);
+        voice->event = sound_event->event;
+        voice->priority = params->priority;
+        voice->distance = distance;
+        voice->start_frame = pool->frame;
+        PlaySound(voice->alias);
+    }
 }
 
 internal void
-destroy_entity(
-        Game *game,
-        Handle handle)
+audio_flush(
+        AudioVoicePool *pool,
+        SoundEventQueue *queue,
+        Vector2 listener)
 {
-    Assert(handle.index < ENTITIES_CAPACITY);
-    Entity *entity = game->entities + handle.index;
-    if(entity_flags_contains(&entity->flags, EntityFlagsIndex_Alive))
+    pool->listener = listener;
+    for(SoundEvent sound_event = {0};
+            sound_event_queue_pop(queue, &sound_event);)
     {
-        entity_flags_unset(&entity->flags, EntityFlagsIndex_Alive);
+        audio_play(pool, &sound_event);
     }
+    pool->frame += 1;
 }
 
-internal void
-game_update(
-        Game *game,
-        Inputs inputs,
-        F32 dt) // angn: NOTE: technically always constant, useful
-                // for extra updates if required
+//~ angn: Assets
+// angn: decode (file read, wav/png parse) runs on worker threads, the main
+// thread only uploads finished CPU buffers to the GPU/audio device
+#define ASSET_WORKERS_MAX 4
+#define ASSET_UPLOAD_BUDGET_US 2000 // per frame
+
+typedef enum : U32
 {
-    //- nick: spell editing
-    S8 spell_select = -1;
-    if(inputs[InputTypes_Select_Spell_0] & InputState_Pressed) { spell_select = 0; }
-    else if(inputs[InputTypes_Select_Spell_1] & InputState_Pressed) { spell_select = 1; }
-    else if(inputs[InputTypes_Select_Spell_2] & InputState_Pressed) { spell_select = 2; }
+#define SOUNDS_LIST_X(n, path) AssetId_Sound_##n,
+    SOUNDS_LIST
+#undef SOUNDS_LIST_X
+#define TEXTURES_LIST_X(n, path) AssetId_Texture_##n,
+    TEXTURES_LIST
+#undef TEXTURES_LIST_X
+    AssetId__Count,
+} AssetId;
 
-    if(spell_select >= 0)
-    {
-        SpellData *sc = &game->spell_construction;
+global AssetId asset_id_from_texture[TextureName__Count] =
+{
+#define TEXTURES_LIST_X(n, path) [TextureName_##n] = AssetId_Texture_##n,
+    TEXTURES_LIST
+#undef TEXTURES_LIST_X
+};
+
+typedef enum : U32
+{
+    AssetKind_Sound,
+    AssetKind_Texture,
+} AssetKind;
+
+typedef enum : U64
+{
+    AssetState_Unloaded,
+    AssetState_Decoding,
+    AssetState_Decoded, // angn: CPU buffer ready, waiting on the main thread
+    AssetState_Ready,
+    AssetState_Failed,
+} AssetState;
+
+typedef union AssetPayload AssetPayload;
+union AssetPayload
+{
+    Wave wave;
+    Image image;
+};
 
-        if(game->new_spell)
+typedef struct Asset Asset;
+struct Asset
+{
+    AssetKind kind;
+    U32 name; // angn: SoundName or TextureName
+    String8 path; // angn: interned, null terminated
+    U32 path_id;
+    U64 state; // angn: AssetState, only touched atomically
+    B32 from_pak; // angn: payload points into the pak mapping, do not free it
+
+    //- angn: written by a worker before the state becomes Decoded
+    AssetPayload payload;
+
+    //- angn: hot reload, written by the watcher before reload_state becomes Decoded
+    U64 reload_state; // angn: AssetState, Unloaded when there is nothing pending
+    AssetPayload reload_payload;
+};
+
+typedef struct AssetSystem AssetSystem;
+struct AssetSystem
+{
+    Asset assets[AssetId__Count];
+    Texture2D textures[TextureName__Count];
+
+    //- angn: paths, interned once while describing, only looked up after
+    String8InternTable paths;
+    U32 asset_from_path_id[AssetId__Count + 1];
+
+    U64 next_job; // angn: workers claim assets in order
+    OS_Handle workers[ASSET_WORKERS_MAX];
+    U32 workers_count;
+
+    OS_FileMap pak;
+    U64 start_time_us;
+
+    //- angn: hot reload
+    OS_Handle watch;
+    OS_Handle watcher;
+    U64 watcher_quit;
+};
+
+// angn: directories the watcher reloads assets from (debug builds)
+global char *asset_watch_directories[] =
+{
+    "textures",
+    "audio",
+};
+
+internal AssetState
+asset_decode(
+        Arena *scratch,
+        AssetKind kind,
+        String8 path, // angn: null terminated
+        AssetPayload *payload)
+    // angn: NOTE: the file only lives as long as the decode, the decoded
+    // buffer is raylib's
+{
+    AssetState state = AssetState_Failed;
+    TempArena temp = temp_arena_begin(scratch);
+    String8 data = os_data_from_file_path(scratch, path);
+    char *file_type = (char *)GetFileExtension((char *)path.string);
+
+    if(data.size != 0)
+    {
+        switch(kind)
         {
-            sc->type = game->spell_type_rand[spell_select];
-            printf("spell type: %d\n", sc->type);
-            game->new_spell = 0;
+        case AssetKind_Sound:
+        {
+            payload->wave = LoadWaveFromMemory(file_type, data.string, Cast(int, data.size));
+            if(payload->wave.data != 0) { state = AssetState_Decoded; }
+        } break;
 
-            for(
-                    U8 i = 0;
-                    i < 3;
-                    i++)
-            {
-                game->spell_type_rand[i] = rand() % SpellType__Count;
-            }
-        }
-        else
+        case AssetKind_Texture:
         {
-            if(sc->program_length < SPELL_SLOTS_MAX)
-            {
-                game->spell_programs[sc->program_index][sc->program_length] =
-                    game->spell_instruction_rand[spell_select];
+            payload->image = LoadImageFromMemory(file_type, data.string, Cast(int, data.size));
+            if(payload->image.data != 0) { state = AssetState_Decoded; }
+        } break;
+        }
+    }
 
-                printf("spell instruction: %d\n", game->spell_programs[sc->program_index][sc->program_length]);
+    temp_arena_end(temp);
+    return(state);
+}
 
-                for(
-                    U8 i = 0;
-                    i < 3;
-                    i++)
-                {
-                    // TODO: the rest
-                    game->spell_instruction_rand[i] = rand() % 7;
-                }
-            }
-            else
-            {
-                // idk kill them irl or smth
-            }
+internal void
+asset_payload_release(
+        AssetKind kind,
+        AssetPayload *payload)
+{
+    switch(kind)
+    {
+    case AssetKind_Sound: { UnloadWave(payload->wave); } break;
+    case AssetKind_Texture: { UnloadImage(payload->image); } break;
+    }
+}
+
+internal void
+asset_worker_entry(
+        void *params)
+{
+    AssetSystem *system = (AssetSystem *)params;
+    Arena *scratch = arena_make();
+    for(;;)
+    {
+        U64 job = AtomicAddU64(&system->next_job, 1) - 1;
+        if(job >= AssetId__Count)
+        {
+            break;
         }
 
-        sc->program_length++;
+        // angn: assets found in the pak are already decoded
+        Asset *asset = &system->assets[job];
+        if(AtomicLoadU64(&asset->state) == AssetState_Decoding)
+        {
+            AtomicStoreU64(&asset->state, asset_decode(scratch, asset->kind, asset->path, &asset->payload));
+        }
     }
+    arena_destroy(scratch);
+}
+
+internal void
+asset_system_describe(
+        AssetSystem *system,
+        Arena *arena)
+{
+#define SOUNDS_LIST_X(n, p) \
+    system->assets[AssetId_Sound_##n] = (Asset){ .kind = AssetKind_Sound, .name = SoundName_##n, .path = String8Lit(p) };
+    SOUNDS_LIST
+#undef SOUNDS_LIST_X
+#define TEXTURES_LIST_X(n, p) \
+    system->assets[AssetId_Texture_##n] = (Asset){ .kind = AssetKind_Texture, .name = TextureName_##n, .path = String8Lit(p) };
+    TEXTURES_LIST
+#undef TEXTURES_LIST_X
+
+    system->paths = string8_intern_table_make(arena, AssetId__Count);
+    for(U64 ai = 0;
+            ai < AssetId__Count;
+            ai += 1)
+    {
+        Asset *asset = &system->assets[ai];
+        asset->path_id = string8_intern(&system->paths, asset->path);
+        asset->path = string8_from_intern_id(&system->paths, asset->path_id);
+        Assert(asset->path_id == ai + 1 && "every asset needs its own path");
+        system->asset_from_path_id[asset->path_id] = Cast(U32, ai);
+    }
+}
+
+// angn: 0 for paths that are not an asset
+internal Asset *
+asset_from_path(
+        AssetSystem *system,
+        String8 path)
+{
+    U32 path_id = string8_intern_lookup(&system->paths, path);
+    return(path_id ? &system->assets[system->asset_from_path_id[path_id]] : 0);
+}
+
+//~ angn: Pak
+// angn: every asset pre-decoded into the format raylib uploads from, so
+// loading is an mmap and pointers straight into it
+//
+// layout: PakHeader | PakEntry[entries_count] | payloads, each PAK_ALIGN aligned
+#define PAK_PATH "assets.pak"
+#define PAK_MAGIC 0x4b50524f // "ORPK"
+#define PAK_VERSION 1
+#define PAK_ALIGN 64
+#define PAK_ENTRY_PATH_MAX 64
+
+typedef struct PakHeader PakHeader;
+struct PakHeader
+{
+    U32 magic;
+    U32 version;
+    U32 entries_count;
+    U32 _pad;
+};
+
+typedef struct PakEntry PakEntry;
+struct PakEntry
+{
+    char path[PAK_ENTRY_PATH_MAX]; // angn: the loose file it was built from
+    AssetKind kind;
+    U32 _pad;
+    U64 offset;
+    U64 size;
+    union
+    {
+        struct
+        {
+            U32 width;
+            U32 height;
+            U32 format;
+            U32 mipmaps;
+        } image;
+        struct
+        {
+            U32 frame_count;
+            U32 sample_rate;
+            U32 sample_size;
+            U32 channels;
+        } wave;
+    };
+};
+
+internal B32
+pak_build(
+        char *pak_path)
+{
+    Arena *arena = os_get_arena();
+    AssetSystem *system = arena_push_array(arena, AssetSystem, 1);
+    asset_system_describe(system, arena);
+
+    //- angn: decode everything
+    PakEntry entries[AssetId__Count] = {0};
+    U8 *payloads[AssetId__Count] = {0};
+    U64 offset = AlignUpPow2(sizeof(PakHeader) + sizeof(entries), PAK_ALIGN);
+    for(U64 ai = 0;
+            ai < AssetId__Count;
+            ai += 1)
+    {
+        Asset *asset = &system->assets[ai];
+        PakEntry *entry = &entries[ai];
+
+        asset->state = asset_decode(arena, asset->kind, asset->path, &asset->payload);
+        if(asset->state != AssetState_Decoded)
+        {
+            fprintf(stderr, "pak: failed to decode %.*s\n", (int)asset->path.size, asset->path.string);
+            return(0);
+        }
+
+        Assert(asset->path.size < PAK_ENTRY_PATH_MAX);
+        memcpy(entry->path, asset->path.string, Min(asset->path.size, PAK_ENTRY_PATH_MAX - 1));
+        entry->kind = asset->kind;
+
+        switch(asset->kind)
+        {
+        case AssetKind_Sound:
+        {
+            // angn: f32 stereo is what the mixer runs at, upload becomes a copy
+            WaveFormat(&asset->payload.wave, asset->payload.wave.sampleRate, 32, 2);
+            entry->wave.frame_count = asset->payload.wave.frameCount;
+            entry->wave.sample_rate = asset->payload.wave.sampleRate;
+            entry->wave.sample_size = asset->payload.wave.sampleSize;
+            entry->wave.channels = asset->payload.wave.channels;
+            entry->size = (U64)asset->payload.wave.frameCount * asset->payload.wave.channels * (asset->payload.wave.sampleSize / 8);
+            payloads[ai] = asset->payload.wave.data;
+        } break;
+
+        case AssetKind_Texture:
+        {
+            ImageFormat(&asset->payload.image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            entry->image.width = asset->payload.image.width;
+            entry->image.height = asset->payload.image.height;
+            entry->image.format = asset->payload.image.format;
+            entry->image.mipmaps = 1;
+            entry->size = (U64)asset->payload.image.width * asset->payload.image.height * 4;
+            payloads[ai] = asset->payload.image.data;
+        } break;
+        }
+
+        entry->offset = offset;
+        offset = AlignUpPow2(offset + entry->size, PAK_ALIGN);
+    }
+
+    //- angn: write
+    // angn: NOTE: the gaps between payloads are never written, they read back as zeros
+    B32 result = 0;
+    OS_Handle file = os_file_open(OS_AccessFlag_Write, string8_from_cstring(pak_path));
+    if(file.u64[0] != 0)
+    {
+        PakHeader header = { .magic = PAK_MAGIC, .version = PAK_VERSION, .entries_count = AssetId__Count };
+        U64 written = 0;
+        U64 expected = sizeof(header) + sizeof(entries);
+        written += os_file_write(file, 0, &header, sizeof(header));
+        written += os_file_write(file, sizeof(header), entries, sizeof(entries));
+        for(U64 ai = 0;
+                ai < AssetId__Count;
+                ai += 1)
+        {
+            written += os_file_write(file, entries[ai].offset, payloads[ai], entries[ai].size);
+            expected += entries[ai].size;
+        }
+        result = (written == expected);
+        os_file_close(file);
+    }
+
+    //- angn: cleanup
+    for(U64 ai = 0;
+            ai < AssetId__Count;
+            ai += 1)
+    {
+        Asset *asset = &system->assets[ai];
+        asset_payload_release(asset->kind, &asset->payload);
+    }
+
+    return(result);
+}
+
+// angn: an entry whose payload is not all inside the pak, or is not the
+// size its own header says, is never trusted
+internal B32
+pak_entry_valid(
+        PakEntry *entry,
+        U64 pak_size)
+{
+    B32 result = (entry->offset <= pak_size
+            && entry->size <= pak_size - entry->offset
+            && entry->offset % PAK_ALIGN == 0);
+    if(result)
+    {
+        switch(entry->kind)
+        {
+        case AssetKind_Sound:
+        {
+            // angn: NOTE: bounded, so the product below cannot wrap
+            result = ((entry->wave.sample_size == 8 || entry->wave.sample_size == 16 || entry->wave.sample_size == 32)
+                    && entry->wave.channels >= 1 && entry->wave.channels <= 8
+                    && entry->size == (U64)entry->wave.frame_count * entry->wave.channels * (entry->wave.sample_size / 8));
+        } break;
+
+        case AssetKind_Texture:
+        {
+            result = (entry->image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+                    && entry->image.mipmaps == 1
+                    && entry->image.width <= INT32_MAX && entry->image.height <= INT32_MAX
+                    && entry->size == (U64)entry->image.width * entry->image.height * 4);
+        } break;
+
+        default:
+        {
+            result = 0;
+        } break;
+        }
+    }
+    return(result);
+}
+
+internal void
+pak_resolve(
+        AssetSystem *system,
+        OS_FileMap pak)
+    // angn: points every asset found in the pak straight at its payload,
+    // whatever is missing or broken in it is decoded from the loose file
+{
+    if(pak.size < sizeof(PakHeader))
+    {
+        return;
+    }
+
+    PakHeader *header = (PakHeader *)pak.base;
+    if(header->magic != PAK_MAGIC
+            || header->version != PAK_VERSION
+            || header->entries_count > (pak.size - sizeof(PakHeader)) / sizeof(PakEntry))
+    {
+        fprintf(stderr, "pak: ignoring %s, bad header\n", PAK_PATH);
+        return;
+    }
+
+    // angn: one pass over the entries, each path is looked up by its interned id
+    PakEntry *entries = (PakEntry *)(header + 1);
+    for(U32 ei = 0;
+            ei < header->entries_count;
+            ei += 1)
+    {
+        PakEntry *entry = &entries[ei];
+        String8 entry_path = string8_make((U8 *)entry->path, strnlen(entry->path, PAK_ENTRY_PATH_MAX));
+        Asset *asset = asset_from_path(system, entry_path);
+        if(asset == 0
+                || asset->from_pak
+                || entry->kind != asset->kind)
+        {
+            continue;
+        }
+        if(!pak_entry_valid(entry, pak.size))
+        {
+            fprintf(stderr, "pak: bad entry for %.*s, loading the loose file\n", (int)entry_path.size, entry_path.string);
+            continue;
+        }
+
+        void *payload = (U8 *)pak.base + entry->offset;
+        switch(entry->kind)
+        {
+        case AssetKind_Sound:
+        {
+            asset->payload.wave = (Wave)
+            {
+                .frameCount = entry->wave.frame_count,
+                .sampleRate = entry->wave.sample_rate,
+                .sampleSize = entry->wave.sample_size,
+                .channels = entry->wave.channels,
+                .data = payload,
+            };
+        } break;
+
+        case AssetKind_Texture:
+        {
+            asset->payload.image = (Image)
+            {
+                .data = payload,
+                .width = entry->image.width,
+                .height = entry->image.height,
+                .mipmaps = entry->image.mipmaps,
+                .format = entry->image.format,
+            };
+        } break;
+        }
+
+        asset->from_pak = 1;
+        asset->state = AssetState_Decoded;
+    }
+}
+
+internal void
+asset_reload(
+        Arena *scratch,
+        Asset *asset)
+{
+    //- angn: take the reload slot, replacing a reload the main thread has not picked up yet
+    for(;;)
+    {
+        U64 state = AtomicLoadU64(&asset->reload_state);
+        if(state == AssetState_Unloaded
+                && AtomicCompareExchangeU64(&asset->reload_state, AssetState_Unloaded, AssetState_Decoding) == AssetState_Unloaded)
+        {
+            break;
+        }
+        if(state == AssetState_Decoded
+                && AtomicCompareExchangeU64(&asset->reload_state, AssetState_Decoded, AssetState_Decoding) == AssetState_Decoded)
+        {
+            asset_payload_release(asset->kind, &asset->reload_payload);
+            break;
+        }
+        os_sleep_milliseconds(1); // angn: the main thread is uploading the last one
+    }
+
+    AssetState state = asset_decode(scratch, asset->kind, asset->path, &asset->reload_payload);
+    AtomicStoreU64(&asset->reload_state, state == AssetState_Decoded ? AssetState_Decoded : AssetState_Unloaded);
+}
+
+internal void
+asset_watcher_entry(
+        void *params)
+{
+    AssetSystem *system = (AssetSystem *)params;
+    Arena *arena = arena_make();
+    for(;!AtomicLoadU64(&system->watcher_quit);)
+    {
+        TempArena temp = temp_arena_begin(arena);
+        OS_FileWatchEventList events = os_file_watch_wait(arena, system->watch, 100);
+        for EachSLLNode(OS_FileWatchEvent, event, events.first, next)
+        {
+            // angn: still streaming in, the initial load will see the new file anyway
+            Asset *asset = asset_from_path(system, event->path);
+            if(asset == 0 || AtomicLoadU64(&asset->state) != AssetState_Ready)
+            {
+                continue;
+            }
+
+            asset_reload(arena, asset);
+        }
+        temp_arena_end(temp);
+    }
+    arena_destroy(arena);
+}
+
+internal void
+asset_system_init(
+        AssetSystem *system,
+        Arena *arena)
+{
+    system->start_time_us = os_now_microseconds();
+    asset_system_describe(system, arena);
+
+    for(U64 ai = 0;
+            ai < AssetId__Count;
+            ai += 1)
+    {
+        system->assets[ai].state = AssetState_Decoding;
+    }
+
+    //- angn: anything in the pak skips the workers, the rest is loaded loose
+    system->pak = os_file_map(String8Lit(PAK_PATH));
+    if(system->pak.base)
+    {
+        pak_resolve(system, system->pak);
+    }
+
+    // angn: leave a core for the main thread and one for the simulation
+    U32 cores = os_get_system_info()->logical_processor_count;
+    system->workers_count = Min(Max(cores, 3) - 2, Min(ASSET_WORKERS_MAX, AssetId__Count));
+    for(U32 wi = 0;
+            wi < system->workers_count;
+            wi += 1)
+    {
+        system->workers[wi] = os_thread_launch(asset_worker_entry, system);
+    }
+
+    //- angn: hot reload, edited files are re-decoded and swapped at a frame boundary
+#if BUILD_DEBUG
+    system->watch = os_file_watch_open();
+    for EachStaticArray(di, asset_watch_directories)
+    {
+        os_file_watch_add_directory(system->watch, string8_from_cstring(asset_watch_directories[di]));
+    }
+    system->watcher = os_thread_launch(asset_watcher_entry, system);
+#endif
+}
+
+internal AssetState
+asset_state(
+        AssetSystem *system,
+        AssetId id)
+{
+    return(AtomicLoadU64(&system->assets[id].state));
+}
+
+internal U64
+asset_system_ready_count(
+        AssetSystem *system)
+    // angn: failed assets count as done, there is nothing left to wait on
+{
+    U64 result = 0;
+    for(U64 ai = 0;
+            ai < AssetId__Count;
+            ai += 1)
+    {
+        AssetState state = asset_state(system, ai);
+        if(state == AssetState_Ready || state == AssetState_Failed) { result += 1; }
+    }
+    return(result);
+}
+
+internal void
+asset_upload(
+        AssetSystem *system,
+        AudioVoicePool *audio,
+        Asset *asset,
+        AssetPayload *payload)
+{
+    switch(asset->kind)
+    {
+    case AssetKind_Sound:
+    {
+        audio_voice_pool_set_source(audio, asset->name, LoadSoundFromWave(payload->wave));
+    } break;
+
+    case AssetKind_Texture:
+    {
+        Texture2D old_texture = system->textures[asset->name];
+        system->textures[asset->name] = LoadTextureFromImage(payload->image);
+        if(AtomicLoadU64(&asset->state) == AssetState_Ready) { UnloadTexture(old_texture); }
+    } break;
+    }
+}
+
+internal void
+asset_system_upload(
+        AssetSystem *system,
+        AudioVoicePool *audio,
+        U64 budget_us)
+    // angn: NOTE: always uploads at least one asset so loading makes progress
+{
+    U64 start_time = os_now_microseconds();
+    for(U64 ai = 0;
+            ai < AssetId__Count;
+            ai += 1)
+    {
+        Asset *asset = &system->assets[ai];
+
+        //- angn: hot reload, swap in place so every id picks up the new data
+        if(AtomicCompareExchangeU64(&asset->reload_state, AssetState_Decoded, AssetState_Ready) == AssetState_Decoded)
+        {
+            asset_upload(system, audio, asset, &asset->reload_payload);
+            asset_payload_release(asset->kind, &asset->reload_payload);
+            AtomicStoreU64(&asset->reload_state, AssetState_Unloaded);
+            printf("assets: reloaded %.*s\n", (int)asset->path.size, asset->path.string);
+        }
+        else if(AtomicLoadU64(&asset->state) == AssetState_Decoded)
+        {
+            asset_upload(system, audio, asset, &asset->payload);
+            if(!asset->from_pak) { asset_payload_release(asset->kind, &asset->payload); }
+            AtomicStoreU64(&asset->state, AssetState_Ready);
+
+#if BUILD_DEBUG
+            if(asset_system_ready_count(system) == AssetId__Count)
+            {
+                printf("assets: ready in %.2fms (%s)\n",
+                        Cast(F64, os_now_microseconds() - system->start_time_us) / 1000.0,
+                        system->pak.base ? PAK_PATH : "loose files");
+            }
+#endif
+        }
+        else
+        {
+            continue;
+        }
+
+        if(os_now_microseconds() - start_time >= budget_us)
+        {
+            break;
+        }
+    }
+}
+
+internal void
+asset_system_release(
+        AssetSystem *system)
+{
+    AtomicStoreU64(&system->watcher_quit, 1);
+    os_thread_join(system->watcher);
+
+    for(U32 wi = 0;
+            wi < system->workers_count;
+            wi += 1)
+    {
+        os_thread_join(system->workers[wi]);
+    }
+
+    for(U64 ai = 0;
+            ai < AssetId__Count;
+            ai += 1)
+    {
+        Asset *asset = &system->assets[ai];
+        AssetState state = AtomicLoadU64(&asset->state);
+        if(asset->kind == AssetKind_Texture)
+        {
+            if(state == AssetState_Ready) { UnloadTexture(system->textures[asset->name]); }
+            if(state == AssetState_Decoded && !asset->from_pak) { UnloadImage(asset->payload.image); }
+        }
+        if(asset->kind == AssetKind_Sound && state == AssetState_Decoded && !asset->from_pak)
+        {
+            UnloadWave(asset->payload.wave);
+        }
+        if(AtomicLoadU64(&asset->reload_state) == AssetState_Decoded)
+        {
+            asset_payload_release(asset->kind, &asset->reload_payload);
+        }
+    }
+
+    os_file_unmap(system->pak);
+}
+
+internal Texture2D *
+asset_texture(
+        AssetSystem *system,
+        TextureName name)
+    // angn: 0 until the texture is on the GPU
+{
+    Texture2D *result = 0;
+    if(asset_state(system, asset_id_from_texture[name]) == AssetState_Ready)
+    {
+        result = &system->textures[name];
+    }
+    return(result);
+}
+
+//~ angn: Job pool
+// angn: worker threads the game borrows through GameJobs::run, parked on a
+// semaphore between batches. the thread that calls run is worker 0 and works
+// through the batch alongside them
+typedef struct JobPool JobPool;
+typedef struct JobPoolWorker JobPoolWorker;
+
+struct JobPoolWorker
+{
+    JobPool *pool;
+    U64 worker_index;
+    OS_Handle thread;
+};
+
+struct JobPool
+{
+    GameJobs jobs; // angn: what the game is handed
+    JobPoolWorker workers[GAME_WORKERS_MAX];
+    OS_Handle start; // angn: one signal per worker per batch
+    OS_Handle done;  // angn: one signal back per worker per batch
+
+    //- angn: the batch in flight, written before `start` is signalled
+    GameJobProc *proc;
+    void *params;
+    U64 jobs_count;
+    U64 next_job; // angn: claimed atomically
+    U64 quit;
+};
+
+internal void
+job_pool_work(
+        JobPool *pool,
+        U64 worker_index)
+{
+    for(;;)
+    {
+        U64 job_index = AtomicAddU64(&pool->next_job, 1) - 1;
+        if(job_index >= pool->jobs_count)
+        {
+            break;
+        }
+        pool->proc(pool->params, job_index, worker_index);
+    }
+}
+
+internal void
+job_pool_worker_entry(
+        void *params)
+{
+    JobPoolWorker *worker = (JobPoolWorker *)params;
+    JobPool *pool = worker->pool;
+    for(;;)
+    {
+        os_semaphore_wait(pool->start);
+        if(AtomicLoadU64(&pool->quit))
+        {
+            break;
+        }
+        job_pool_work(pool, worker->worker_index);
+        os_semaphore_signal(pool->done, 1);
+    }
+}
+
+internal void
+job_pool_run(
+        GameJobs *jobs,
+        GameJobProc *proc,
+        void *params,
+        U64 jobs_count)
+{
+    JobPool *pool = (JobPool *)jobs->pool;
+    U64 helpers_count = jobs_count > 1 ? Min(jobs->workers_count, jobs_count) - 1 : 0;
+    if(helpers_count == 0)
+    {
+        for(U64 ji = 0;
+                ji < jobs_count;
+                ji += 1)
+        {
+            proc(params, ji, 0);
+        }
+        return;
+    }
+
+    pool->proc = proc;
+    pool->params = params;
+    pool->jobs_count = jobs_count;
+    AtomicStoreU64(&pool->next_job, 0);
+    os_semaphore_signal(pool->start, Cast(U32, helpers_count));
+    job_pool_work(pool, 0);
+    for(U64 hi = 0;
+            hi < helpers_count;
+            hi += 1)
+    {
+        os_semaphore_wait(pool->done);
+    }
+}
+
+// angn: NOTE: launches threads, main thread only
+internal JobPool *
+job_pool_make(
+        Arena *arena,
+        U64 workers_count)
+{
+    JobPool *pool = arena_push_array(arena, JobPool, 1);
+    workers_count = Min(Max(workers_count, 1), GAME_WORKERS_MAX);
+    pool->jobs.run = job_pool_run;
+    pool->jobs.pool = pool;
+    pool->jobs.workers_count = workers_count;
+    pool->jobs.now_microseconds = os_now_microseconds;
+    pool->start = os_semaphore_alloc(0);
+    pool->done = os_semaphore_alloc(0);
+    for(U64 wi = 0;
+            wi < workers_count;
+            wi += 1)
+    {
+        pool->jobs.scratch[wi] = arena_make();
+        pool->workers[wi].pool = pool;
+        pool->workers[wi].worker_index = wi;
+        if(wi != 0)
+        {
+            pool->workers[wi].thread = os_thread_launch(job_pool_worker_entry, &pool->workers[wi]);
+        }
+    }
+    return(pool);
+}
+
+internal void
+job_pool_release(
+        JobPool *pool)
+{
+    AtomicStoreU64(&pool->quit, 1);
+    os_semaphore_signal(pool->start, Cast(U32, pool->jobs.workers_count - 1));
+    for(U64 wi = 0;
+            wi < pool->jobs.workers_count;
+            wi += 1)
+    {
+        if(wi != 0)
+        {
+            os_thread_join(pool->workers[wi].thread);
+        }
+        arena_destroy(pool->jobs.scratch[wi]);
+    }
+    os_semaphore_release(pool->start);
+    os_semaphore_release(pool->done);
+}
+
+//~ angn: Game code loading
+// angn: the library is copied before loading so the compiler is free to
+// overwrite the original, and a fresh name every time keeps dlopen from
+// handing back the library it already has
+#if OS_WINDOWS
+    #define GAME_LIBRARY_PATH "orthography_game.dll"
+    #define GAME_LIBRARY_LOADED_FORMAT "orthography_game_loaded_%llu.dll"
+#else
+    #define GAME_LIBRARY_PATH "./orthography_game.so"
+    #define GAME_LIBRARY_LOADED_FORMAT "./orthography_game_loaded_%llu.so"
+#endif
+
+typedef struct GameCode GameCode;
+struct GameCode
+{
+    GameApi api;
+
+    //- angn: hot reload
+    OS_Handle library;
+    U64 library_time; // angn: modified time of the library we last tried
+    U64 loads_count;
+};
+
+#if BUILD_HOT_RELOAD
+internal B32
+game_code_load(
+        GameCode *code,
+        Arena *scratch)
+{
+    B32 result = 0;
+    String8 library_path = string8_from_cstring(GAME_LIBRARY_PATH);
+    U64 library_time = os_file_modified_time(library_path);
+    if(library_time != 0 && library_time != code->library_time)
+    {
+        code->library_time = library_time;
+        U64 start_time_us = os_now_microseconds();
+
+        //- angn: copy
+        char loaded_path_cstr[OS_PATH_MAX] = {0};
+        snprintf(loaded_path_cstr, sizeof(loaded_path_cstr), GAME_LIBRARY_LOADED_FORMAT, Cast(unsigned long long, code->loads_count));
+        String8 loaded_path = string8_from_cstring(loaded_path_cstr);
+
+        U64 scratch_pos = arena_pos(scratch);
+        String8 library_data = os_data_from_file_path(scratch, library_path);
+        B32 copied = library_data.size != 0 && os_write_data_to_file_path(loaded_path, library_data);
+        arena_pop_to(scratch, scratch_pos);
+
+        //- angn: load
+        OS_Handle library = {0};
+        GameApi api = {0};
+        if(copied)
+        {
+            library = os_library_open(loaded_path);
+            GameGetApiProc *get_api = (GameGetApiProc *)os_library_load_proc(library, GAME_API_PROC_NAME);
+            if(get_api) { api = get_api(); }
+        }
+
+        // angn: NOTE: a library built against a different `Game` would read the
+        // live state with the wrong layout, keep running the old code instead
+        if(api.version == GAME_API_VERSION &&
+                api.game_size == sizeof(Game) &&
+                api.load &&
+                api.init &&
+                api.update)
+        {
+            if(code->loads_count != 0)
+            {
+                char old_path_cstr[OS_PATH_MAX] = {0};
+                snprintf(old_path_cstr, sizeof(old_path_cstr), GAME_LIBRARY_LOADED_FORMAT, Cast(unsigned long long, code->loads_count - 1));
+                os_library_close(code->library);
+                os_file_delete(string8_from_cstring(old_path_cstr));
+            }
+            api.load(os_get_system_info());
+            code->api = api;
+            code->library = library;
+            code->loads_count += 1;
+            result = 1;
+
+            printf("INFO: GAME: loaded %s in %.3fms\n",
+                    loaded_path_cstr,
+                    Cast(F64, os_now_microseconds() - start_time_us) / 1000.0);
+        }
+        else
+        {
+            fprintf(stderr, "WARNING: GAME: %s does not match this build, not loading it\n", GAME_LIBRARY_PATH);
+            os_library_close(library);
+            if(copied) { os_file_delete(loaded_path); }
+        }
+    }
+    return(result);
+}
+
+internal void
+game_code_release(
+        GameCode *code)
+{
+    if(code->loads_count != 0)
+    {
+        char loaded_path_cstr[OS_PATH_MAX] = {0};
+        snprintf(loaded_path_cstr, sizeof(loaded_path_cstr), GAME_LIBRARY_LOADED_FORMAT, Cast(unsigned long long, code->loads_count - 1));
+        os_library_close(code->library);
+        os_file_delete(string8_from_cstring(loaded_path_cstr));
+    }
+}
+#else
+internal B32
+game_code_load(
+        GameCode *code,
+        Arena *scratch)
+{
+    (void)scratch;
+    B32 result = code->loads_count == 0;
+    code->api = game_get_api();
+    code->api.load(os_get_system_info());
+    code->loads_count = 1;
+    return(result);
+}
+
+internal void
+game_code_release(
+        GameCode *code)
+{
+    (void)code;
+}
+#endif
+
+//~ angn: State hash
+// angn: one hash per tick over everything game_update reads back, two runs of
+// the same inputs must produce the same stream, so an optimisation that
+// changes results shows up at the first tick it does it
+// angn: NOTE: fields are mixed one at a time, struct padding is never hashed
+#define STATE_HASH_MAGIC 0x48534852 // "RHSH"
+#define STATE_HASH_VERSION 1
+#define STATE_HASH_FLUSH_COUNT 256
+
+typedef struct StateHashHeader StateHashHeader;
+struct StateHashHeader
+{
+    U32 magic;
+    U32 version;
+};
+
+typedef struct StateHashStream StateHashStream;
+struct StateHashStream
+{
+    OS_Handle file;
+    U64 offset;
+    U64 buffer[STATE_HASH_FLUSH_COUNT];
+    U64 buffer_count;
+};
+
+internal U64
+state_hash_u64(
+        U64 hash,
+        U64 value)
+{
+    hash = (hash ^ value) * 0x9e3779b97f4a7c15ull;
+    return(hash ^ (hash >> 32));
+}
+
+internal U64
+state_hash_f32(
+        U64 hash,
+        F32 value)
+{
+    U32 bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    return(state_hash_u64(hash, bits));
+}
+
+internal U64
+state_hash_spell(
+        U64 hash,
+        SpellData *spell)
+{
+    hash = state_hash_u64(hash, spell->type);
+    hash = state_hash_u64(hash, U64FromTwoU32s(
+                (spell->program_index << 16) | (spell->program_length << 8) | spell->slot_index,
+                (spell->lifetime << 16) | (spell->tick << 8) | spell->ticks_per_step));
+    hash = state_hash_f32(hash, spell->rotation);
+    hash = state_hash_u64(hash, spell->armed);
+    return(hash);
+}
+
+internal U64
+state_hash_game(
+        Game *game)
+{
+    U64 hash = 0xcbf29ce484222325ull;
+    hash = state_hash_u64(hash, game->random.state);
+    hash = state_hash_u64(hash, game->random.increment);
+    hash = state_hash_u64(hash, game->entities_count);
+
+    //- angn: entities
+    for(U64 ei = 0;
+            ei < ENTITIES_CAPACITY;
+            ei += 1)
+    {
+        Entity *entity = &game->entities[ei];
+        if(!entity_flags_contains(&entity->flags, EntityFlagsIndex_Alive))
+        {
+            continue;
+        }
+        hash = state_hash_u64(hash, ei);
+        hash = state_hash_u64(hash, entity->handle.gen);
+        hash = state_hash_u64(hash, entity->flags.f[0]);
+        hash = state_hash_u64(hash, entity->player_state);
+        hash = state_hash_f32(hash, entity->position.x);
+        hash = state_hash_f32(hash, entity->position.y);
+        hash = state_hash_f32(hash, entity->velocity.x);
+        hash = state_hash_f32(hash, entity->velocity.y);
+        hash = state_hash_u64(hash, entity->still_ticks);
+        hash = state_hash_spell(hash, &entity->spell_data);
+    }
+
+    //- nick: spells
+    hash = state_hash_spell(hash, &game->spell_construction);
+    for(U64 pi = 0;
+            pi < SPELL_PROGRAMS_MAX;
+            pi += 1)
+    {
+        for(U64 si = 0;
+                si < SPELL_SLOTS_MAX;
+                si += 1)
+        {
+            hash = state_hash_u64(hash, game->spell_programs[pi][si]);
+        }
+    }
+    for(U64 ri = 0;
+            ri < StaticArrayLength(game->spell_type_rand);
+            ri += 1)
+    {
+        hash = state_hash_u64(hash, game->spell_type_rand[ri]);
+        hash = state_hash_u64(hash, game->spell_instruction_rand[ri]);
+    }
+    hash = state_hash_u64(hash, game->new_spell);
+
+    return(hash);
+}
+
+internal B32
+state_hash_stream_open(
+        StateHashStream *stream,
+        String8 path)
+{
+    StateHashHeader header = { .magic = STATE_HASH_MAGIC, .version = STATE_HASH_VERSION };
+    stream->file = os_file_open(OS_AccessFlag_Write, path);
+    stream->offset = 0;
+    stream->buffer_count = 0;
+    if(stream->file.u64[0] != 0)
+    {
+        stream->offset = os_file_write(stream->file, 0, &header, sizeof(header));
+    }
+    return(stream->offset == sizeof(header));
+}
+
+internal void
+state_hash_stream_flush(
+        StateHashStream *stream)
+{
+    stream->offset += os_file_write(stream->file, stream->offset, stream->buffer, stream->buffer_count * sizeof(U64));
+    stream->buffer_count = 0;
+}
+
+internal void
+state_hash_stream_push(
+        StateHashStream *stream,
+        Game *game)
+{
+    stream->buffer[stream->buffer_count] = state_hash_game(game);
+    stream->buffer_count += 1;
+    if(stream->buffer_count == STATE_HASH_FLUSH_COUNT)
+    {
+        state_hash_stream_flush(stream);
+    }
+}
+
+internal void
+state_hash_stream_close(
+        StateHashStream *stream)
+{
+    state_hash_stream_flush(stream);
+    os_file_close(stream->file);
+}
+
+// angn: 0 if both streams agree for as long as they both go
+internal int
+state_hash_compare(
+        Arena *arena,
+        String8 path_a,
+        String8 path_b)
+{
+    String8 paths[2] = { path_a, path_b };
+    U64 *hashes[2] = {0};
+    U64 counts[2] = {0};
+    for(U64 i = 0;
+            i < 2;
+            i += 1)
+    {
+        String8 data = os_data_from_file_path(arena, paths[i]);
+        StateHashHeader header = {0};
+        if(data.size >= sizeof(header)) { memcpy(&header, data.string, sizeof(header)); }
+        if(header.magic != STATE_HASH_MAGIC || header.version != STATE_HASH_VERSION)
+        {
+            fprintf(stderr, "ERROR: HASH: %.*s is not a hash stream\n", (int)paths[i].size, paths[i].string);
+            return(2);
+        }
+        hashes[i] = (U64 *)(data.string + sizeof(header));
+        counts[i] = (data.size - sizeof(header)) / sizeof(U64);
+    }
+
+    U64 count = Min(counts[0], counts[1]);
+    for(U64 ti = 0;
+            ti < count;
+            ti += 1)
+    {
+        if(hashes[0][ti] != hashes[1][ti])
+        {
+            printf("HASH: diverged at tick %llu: %016llx != %016llx\n",
+                    Cast(unsigned long long, ti),
+                    Cast(unsigned long long, hashes[0][ti]),
+                    Cast(unsigned long long, hashes[1][ti]));
+            return(1);
+        }
+    }
+
+    printf("HASH: %llu ticks match", Cast(unsigned long long, count));
+    if(counts[0] != counts[1])
+    {
+        printf(" (lengths differ, %llu vs %llu)", Cast(unsigned long long, counts[0]), Cast(unsigned long long, counts[1]));
+    }
+    printf("\n");
+    return(0);
+}
+
+//~ angn: Game snapshots
+// angn: `Game` is flat apart from Animation::frames, files store the frames
+// after the game in entity order and rebuild the pointers on load
+// angn: NOTE: in memory snapshots keep the pointers, frames are never freed
+#define GAME_SNAPSHOT_PATH "game.snapshot"
+#define GAME_SNAPSHOT_MAGIC 0x50534e47 // "GNSP"
+#define GAME_SNAPSHOT_VERSION 1
+#define GAME_SNAPSHOT_RING_COUNT 8
+#define GAME_SNAPSHOT_RING_INTERVAL 60 // ticks
+
+typedef struct GameSnapshotHeader GameSnapshotHeader;
+struct GameSnapshotHeader
+{
+    U32 magic;
+    U32 version;
+    U64 game_api_version;
+    U64 game_size;
+    U64 frames_count;
+};
+
+typedef struct GameSnapshotRing GameSnapshotRing;
+struct GameSnapshotRing
+{
+    Game *slots; // angn: GAME_SNAPSHOT_RING_COUNT of them
+    U64 taken_count;
+};
+
+internal B32
+game_snapshot_save(
+        Arena *scratch,
+        Game *game,
+        String8 path)
+{
+    U64 scratch_pos = arena_pos(scratch);
+
+    //- angn: flatten
+    Game *flat = arena_push_array_no_zero(scratch, Game, 1);
+    memcpy(flat, game, sizeof(Game));
+    U64 frames_count = 0;
+    for(U64 ei = 0;
+            ei < ENTITIES_CAPACITY;
+            ei += 1)
+    {
+        for(U64 ai = 0;
+                ai < ANIMATION_CAPACITY;
+                ai += 1)
+        {
+            flat->entities[ei].animations[ai].frames = 0;
+            frames_count += flat->entities[ei].animations[ai].frames_size;
+        }
+    }
+
+    AnimationFrame *frames = arena_push_array_no_zero(scratch, AnimationFrame, frames_count);
+    AnimationFrame *frames_at = frames;
+    for(U64 ei = 0;
+            ei < ENTITIES_CAPACITY;
+            ei += 1)
+    {
+        for(U64 ai = 0;
+                ai < ANIMATION_CAPACITY;
+                ai += 1)
+        {
+            Animation *animation = &game->entities[ei].animations[ai];
+            if(animation->frames_size != 0)
+            {
+                memcpy(frames_at, animation->frames, animation->frames_size * sizeof(AnimationFrame));
+                frames_at += animation->frames_size;
+            }
+        }
+    }
+
+    //- angn: write
+    GameSnapshotHeader header =
+    {
+        .magic = GAME_SNAPSHOT_MAGIC,
+        .version = GAME_SNAPSHOT_VERSION,
+        .game_api_version = GAME_API_VERSION,
+        .game_size = sizeof(Game),
+        .frames_count = frames_count,
+    };
+
+    B32 result = 0;
+    OS_Handle file = os_file_open(OS_AccessFlag_Write, path);
+    if(file.u64[0] != 0)
+    {
+        U64 offset = 0;
+        offset += os_file_write(file, offset, &header, sizeof(header));
+        offset += os_file_write(file, offset, flat, sizeof(Game));
+        offset += os_file_write(file, offset, frames, frames_count * sizeof(AnimationFrame));
+        result = offset == sizeof(header) + sizeof(Game) + frames_count * sizeof(AnimationFrame);
+        os_file_close(file);
+    }
+
+    arena_pop_to(scratch, scratch_pos);
+    return(result);
+}
+
+// angn: frames go on `arena`, everything else straight over `game`
+internal B32
+game_snapshot_load(
+        Arena *arena,
+        Arena *scratch,
+        Game *game,
+        String8 path)
+{
+    U64 scratch_pos = arena_pos(scratch);
+    String8 data = os_data_from_file_path(scratch, path);
+
+    GameSnapshotHeader header = {0};
+    if(data.size >= sizeof(header)) { memcpy(&header, data.string, sizeof(header)); }
+
+    B32 result = (header.magic == GAME_SNAPSHOT_MAGIC &&
+            header.version == GAME_SNAPSHOT_VERSION &&
+            header.game_api_version == GAME_API_VERSION &&
+            header.game_size == sizeof(Game) &&
+            data.size == sizeof(header) + sizeof(Game) + header.frames_count * sizeof(AnimationFrame));
+    if(result)
+    {
+        memcpy(game, data.string + sizeof(header), sizeof(Game));
+        AnimationFrame *frames_at = (AnimationFrame *)(data.string + sizeof(header) + sizeof(Game));
+        for(U64 ei = 0;
+                ei < ENTITIES_CAPACITY;
+                ei += 1)
+        {
+            for(U64 ai = 0;
+                    ai < ANIMATION_CAPACITY;
+                    ai += 1)
+            {
+                Animation *animation = &game->entities[ei].animations[ai];
+                if(animation->frames_size != 0)
+                {
+                    animation->frames = arena_push_array_no_zero(arena, AnimationFrame, animation->frames_size);
+                    memcpy(animation->frames, frames_at, animation->frames_size * sizeof(AnimationFrame));
+                    frames_at += animation->frames_size;
+                }
+            }
+        }
+        game->sound_events_count = 0;
+    }
+
+    arena_pop_to(scratch, scratch_pos);
+    return(result);
+}
+
+internal void
+game_snapshot_ring_take(
+        GameSnapshotRing *ring,
+        Game *game)
+{
+    memcpy(&ring->slots[ring->taken_count % GAME_SNAPSHOT_RING_COUNT], game, sizeof(Game));
+    ring->taken_count += 1;
+}
+
+// angn: the oldest snapshot still in the ring, as far back as we can go
+internal B32
+game_snapshot_ring_rewind(
+        GameSnapshotRing *ring,
+        Game *game)
+{
+    B32 result = ring->taken_count != 0;
+    if(result)
+    {
+        U64 oldest = ring->taken_count > GAME_SNAPSHOT_RING_COUNT ? ring->taken_count - GAME_SNAPSHOT_RING_COUNT : 0;
+        memcpy(game, &ring->slots[oldest % GAME_SNAPSHOT_RING_COUNT], sizeof(Game));
+        game->sound_events_count = 0;
+        ring->taken_count = oldest + 1;
+    }
+    return(result);
+}
+
+//~ angn: Replay
+// angn: everything a session depends on is the seed, the fixed dt, the screen
+// and the inputs each tick saw, so that is all a recording holds
+// angn: NOTE: the screen is only taken at the start, resizing mid-session
+// will not replay the same
+// angn: NOTE: a session started from --load keeps the snapshot's path, the
+// snapshot itself has to still be there (and unchanged) to replay it.
+// loading snapshots mid-session is refused while recording
+#define REPLAY_MAGIC 0x59504c52 // "RLPY"
+#define REPLAY_VERSION 2
+#define REPLAY_FLUSH_TICKS 256
+#define REPLAY_SNAPSHOT_PATH_MAX 256
+
+typedef struct ReplayHeader ReplayHeader;
+struct ReplayHeader
+{
+    U32 magic;
+    U32 version;
+    U64 seed;
+    F32 dt_fixed;
+    S32 screen_x;
+    S32 screen_y;
+    U32 reserved;
+    U64 start_hash; // angn: state_hash_game of the first tick's starting state
+    U8 snapshot_path[REPLAY_SNAPSHOT_PATH_MAX]; // angn: zero terminated, empty unless started from a snapshot
+};
+
+// angn: 3 bits per input, Down, Pressed and Released. Up is just not Down
+typedef U32 ReplayTick;
+StaticAssert(InputTypes__Count * 3 <= sizeof(ReplayTick) * 8, replay_tick_fits_inputs);
+
+typedef struct ReplayRecorder ReplayRecorder;
+struct ReplayRecorder
+{
+    OS_Handle file;
+    U64 offset;
+    ReplayTick buffer[REPLAY_FLUSH_TICKS];
+    U64 buffer_count;
+};
+
+internal ReplayTick
+replay_tick_from_inputs(
+        Inputs inputs)
+{
+    ReplayTick tick = 0;
+    for(InputTypes ki = 0;
+            ki < InputTypes__Count;
+            ki += 1)
+    {
+        U32 bits = 0;
+        if(inputs[ki] & InputState_Down) { bits |= 1; }
+        if(inputs[ki] & InputState_Pressed) { bits |= 2; }
+        if(inputs[ki] & InputState_Released) { bits |= 4; }
+        tick |= bits << (ki * 3);
+    }
+    return(tick);
+}
+
+internal void
+replay_inputs_from_tick(
+        ReplayTick tick,
+        Inputs inputs)
+{
+    for(InputTypes ki = 0;
+            ki < InputTypes__Count;
+            ki += 1)
+    {
+        U32 bits = (tick >> (ki * 3)) & 7;
+        inputs[ki] = (bits & 1) ? InputState_Down : InputState_Up;
+        if(bits & 2) { inputs[ki] |= InputState_Pressed; }
+        if(bits & 4) { inputs[ki] |= InputState_Released; }
+    }
+}
+
+internal B32
+replay_recorder_open(
+        ReplayRecorder *recorder,
+        String8 path,
+        Game *game,
+        F32 dt_fixed,
+        String8 snapshot_path) // angn: empty unless `game` came from a snapshot
+{
+    ReplayHeader header =
+    {
+        .magic = REPLAY_MAGIC,
+        .version = REPLAY_VERSION,
+        .seed = game->seed,
+        .dt_fixed = dt_fixed,
+        .screen_x = game->screen.x,
+        .screen_y = game->screen.y,
+        .start_hash = state_hash_game(game),
+    };
+    if(snapshot_path.size >= REPLAY_SNAPSHOT_PATH_MAX)
+    {
+        fprintf(stderr, "ERROR: REPLAY: snapshot path %.*s is too long to record\n", (int)snapshot_path.size, snapshot_path.string);
+        return(0);
+    }
+    memcpy(header.snapshot_path, snapshot_path.string, snapshot_path.size);
+
+    recorder->file = os_file_open(OS_AccessFlag_Write, path);
+    recorder->offset = 0;
+    recorder->buffer_count = 0;
+    if(recorder->file.u64[0] != 0)
+    {
+        recorder->offset = os_file_write(recorder->file, 0, &header, sizeof(header));
+    }
+    return(recorder->offset == sizeof(header));
+}
+
+internal void
+replay_recorder_flush(
+        ReplayRecorder *recorder)
+{
+    U64 size = recorder->buffer_count * sizeof(ReplayTick);
+    recorder->offset += os_file_write(recorder->file, recorder->offset, recorder->buffer, size);
+    recorder->buffer_count = 0;
+}
+
+internal void
+replay_record(
+        ReplayRecorder *recorder,
+        Inputs inputs)
+{
+    recorder->buffer[recorder->buffer_count] = replay_tick_from_inputs(inputs);
+    recorder->buffer_count += 1;
+    if(recorder->buffer_count == REPLAY_FLUSH_TICKS)
+    {
+        replay_recorder_flush(recorder);
+    }
+}
+
+internal void
+replay_recorder_close(
+        ReplayRecorder *recorder)
+{
+    replay_recorder_flush(recorder);
+    os_file_close(recorder->file);
+}
+
+// angn: where the ticks went, per system, summed over every chunk and worker
+internal void
+game_system_times_print(
+        Game *game,
+        U64 ticks_count)
+{
+    for(U64 si = 0;
+            si < GameSystem__Count;
+            si += 1)
+    {
+        printf("INFO: SYSTEMS: %-10s %.3fus per tick\n",
+                game_system_names[si],
+                ticks_count ? Cast(F64, game->system_time_us[si]) / Cast(F64, ticks_count) : 0.0);
+    }
+}
+
+// angn: runs a recording as fast as it goes, no window, no audio, for
+// profiling the exact same session before and after a change
+internal int
+replay_run(
+        Arena *arena,
+        String8 path,
+        StateHashStream *hashes, // angn: optional
+        U64 workers_count)
+{
+    String8 data = os_data_from_file_path(arena, path);
+    ReplayHeader header = {0};
+    if(data.size >= sizeof(header)) { memcpy(&header, data.string, sizeof(header)); }
+    if(header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION)
+    {
+        fprintf(stderr, "ERROR: REPLAY: %.*s is not a replay\n", (int)path.size, path.string);
+        return(1);
+    }
+    ReplayTick *ticks = (ReplayTick *)(data.string + sizeof(header));
+    U64 ticks_count = (data.size - sizeof(header)) / sizeof(ReplayTick);
+
+    //- angn: same starting state as the recording
+    Game *game = arena_push_array(arena, Game, 1);
+    game->screen.x = header.screen_x;
+    game->screen.y = header.screen_y;
+    game->seed = header.seed;
+
+    GameCode *code = arena_push_array(arena, GameCode, 1);
+    if(!game_code_load(code, arena))
+    {
+        fprintf(stderr, "could not load %s\n", GAME_LIBRARY_PATH);
+        return(1);
+    }
+    code->api.init(game, arena);
+    if(header.snapshot_path[0] != 0)
+    {
+        header.snapshot_path[REPLAY_SNAPSHOT_PATH_MAX - 1] = 0;
+        String8 snapshot_path = string8_from_cstring((char *)header.snapshot_path);
+        Arena *scratch = arena_make();
+        B32 loaded = game_snapshot_load(arena, scratch, game, snapshot_path);
+        arena_destroy(scratch);
+        if(!loaded)
+        {
+            fprintf(stderr, "ERROR: REPLAY: could not load the starting snapshot %.*s\n", (int)snapshot_path.size, snapshot_path.string);
+            game_code_release(code);
+            return(1);
+        }
+    }
+    if(state_hash_game(game) != header.start_hash)
+    {
+        fprintf(stderr, "WARNING: REPLAY: starting state differs from the recording's, it will not replay the same\n");
+    }
+    JobPool *pool = job_pool_make(arena, workers_count);
+
+    //- angn: replay
+    U64 start_time_us = os_now_microseconds();
+    Inputs inputs = {0};
+    for(U64 ti = 0;
+            ti < ticks_count;
+            ti += 1)
+    {
+        replay_inputs_from_tick(ticks[ti], inputs);
+        code->api.update(game, &pool->jobs, inputs, header.dt_fixed, 0);
+        game->sound_events_count = 0;
+        if(hashes) { state_hash_stream_push(hashes, game); }
+    }
+    U64 elapsed_us = os_now_microseconds() - start_time_us;
+
+    printf("INFO: REPLAY: %llu ticks in %.3fms, %.3fus per tick, %llu entities alive, %llu workers\n",
+            Cast(unsigned long long, ticks_count),
+            Cast(F64, elapsed_us) / 1000.0,
+            ticks_count ? Cast(F64, elapsed_us) / Cast(F64, ticks_count) : 0.0,
+            Cast(unsigned long long, game->entities_count),
+            Cast(unsigned long long, pool->jobs.workers_count));
+    game_system_times_print(game, ticks_count);
+    job_pool_release(pool);
+    game_code_release(code);
+    return(0);
+}
+
+//~ angn: Benchmarks
+// angn: headless timings of the hot kernels, wide path against the scalar one
+#define BENCH_ITERATIONS 1000
+
+typedef void BenchMotionProc(F32 *px, F32 *py, F32 *vx, F32 *vy, F32 *scale, U64 count);
+
+internal void
+bench_motion_friction_scalar(
+        F32 *px,
+        F32 *py,
+        F32 *vx,
+        F32 *vy,
+        F32 *scale,
+        U64 count)
+{
+    (void)px;
+    (void)py;
+    motion_apply_friction_scalar(vx, vy, scale, count);
+}
+
+internal void
+bench_motion_friction(
+        F32 *px,
+        F32 *py,
+        F32 *vx,
+        F32 *vy,
+        F32 *scale,
+        U64 count)
+{
+    (void)px;
+    (void)py;
+    motion_apply_friction(vx, vy, scale, count);
+}
+
+internal F64
+bench_motion_ns_per_entity(
+        BenchMotionProc *proc,
+        F32 **arrays,
+        U64 count)
+{
+    U64 start_time_us = os_now_microseconds();
+    for(U64 it = 0;
+            it < BENCH_ITERATIONS;
+            it += 1)
+    {
+        proc(arrays[0], arrays[1], arrays[2], arrays[3], arrays[4], count);
+    }
+    U64 elapsed_us = os_now_microseconds() - start_time_us;
+    return(Cast(F64, elapsed_us) * 1000.0 / Cast(F64, BENCH_ITERATIONS * count));
+}
+
+internal int
+bench_motion(
+        Arena *arena)
+{
+    char *path =
+#if SIMD_AVX2
+        "avx2";
+#elif SIMD_SSE2
+        "sse2";
+#elif SIMD_NEON
+        "neon";
+#else
+        "scalar";
+#endif
+
+    U64 counts[] = { 4096, 65536 };
+    struct { char *name; BenchMotionProc *scalar; BenchMotionProc *wide; } kernels[] =
+    {
+        { "friction",  bench_motion_friction_scalar, bench_motion_friction },
+        { "integrate", motion_integrate_scalar, motion_integrate },
+    };
+
+    RandomState random = random_make(1, 0);
+    for(U64 ci = 0;
+            ci < StaticArrayLength(counts);
+            ci += 1)
+    {
+        U64 count = counts[ci];
+        U64 arena_pos_start = arena_pos(arena);
+        F32 *arrays[5] = {0};
+        for(U64 ai = 0;
+                ai < StaticArrayLength(arrays);
+                ai += 1)
+        {
+            arrays[ai] = arena_push_array_no_zero(arena, F32, count);
+            for(U64 i = 0;
+                    i < count;
+                    i += 1)
+            {
+                arrays[ai][i] = random_f32(&random);
+            }
+        }
+        // angn: NOTE: small scales so a thousand runs never decay into
+        // denormals, and a quarter of the lanes masked off like dead entities
+        for(U64 i = 0;
+                i < count;
+                i += 1)
+        {
+            arrays[4][i] = (i % 4 == 0) ? 0.0f : arrays[4][i] * 0.001f;
+        }
+
+        for(U64 ki = 0;
+                ki < StaticArrayLength(kernels);
+                ki += 1)
+        {
+            F64 scalar_ns = bench_motion_ns_per_entity(kernels[ki].scalar, arrays, count);
+            F64 wide_ns = bench_motion_ns_per_entity(kernels[ki].wide, arrays, count);
+            printf("BENCH: motion %-9s %6llu entities: scalar %.3fns, %s %.3fns per entity (%.2fx)\n",
+                    kernels[ki].name,
+                    Cast(unsigned long long, count),
+                    scalar_ns,
+                    path,
+                    wide_ns,
+                    wide_ns > 0.0 ? scalar_ns / wide_ns : 0.0);
+        }
+        arena_pop_to(arena, arena_pos_start);
+    }
+    return(0);
+}
+
+// angn: the same crowd of bouncing colliders run for a fixed number of ticks
+// on 1 to N workers, every run has to hash the same as the 1 worker one
+#define BENCH_COLLISION_ENTITIES 4000
+#define BENCH_COLLISION_TICKS    120
+#define BENCH_COLLISION_AREA     2000.0f
+
+internal void
+bench_collisions_spawn(
+        Game *game,
+        U64 index,
+        Vector2 position,
+        Vector2 velocity,
+        Rectangle collision,
+        B32 moves)
+{
+    Entity *entity = &game->entities[index];
+    entity->handle = (Handle){ .index = index, .gen = 1 };
+    entity->position = position;
+    entity->prev_position = position;
+    entity->velocity = velocity;
+    entity->collision = collision;
+    entity_flags_set_in(game, entity, EntityFlagsIndex_Alive);
+    entity_flags_set_in(game, entity, EntityFlagsIndex_Collider);
+    if(moves)
+    {
+        entity_flags_set_in(game, entity, EntityFlagsIndex_ApplyVelocity);
+        entity_flags_set_in(game, entity, EntityFlagsIndex_ApplyBounce);
+    }
+    game->entities_count += 1;
+}
+
+internal U64
+bench_collisions_hash(
+        Game *game,
+        GameTickOutput *output)
+{
+    U64 hash = state_hash_game(game);
+    for(U64 ei = 0;
+            ei < output->collision_events_count;
+            ei += 1)
+    {
+        CollisionEvent *event = &output->collision_events[ei];
+        hash = state_hash_u64(hash, event->kind);
+        hash = state_hash_u64(hash, event->a.index);
+        hash = state_hash_u64(hash, event->b.index);
+        hash = state_hash_f32(hash, event->time);
+    }
+    return(hash);
+}
+
+internal int
+bench_collisions(
+        Arena *arena)
+{
+    GameCode *code = arena_push_array(arena, GameCode, 1);
+    if(!game_code_load(code, arena))
+    {
+        fprintf(stderr, "could not load %s\n", GAME_LIBRARY_PATH);
+        return(1);
+    }
+
+    //- angn: a box of four static walls full of small bouncing colliders
+    Game *start = arena_push_array(arena, Game, 1);
+    start->screen = (Vec2S32){ Cast(S32, BENCH_COLLISION_AREA), Cast(S32, BENCH_COLLISION_AREA) };
+    F32 area = BENCH_COLLISION_AREA;
+    bench_collisions_spawn(start, 0, (Vector2){ -16.0f, -16.0f }, (Vector2){0}, (Rectangle){ 0, 0, area + 32.0f, 16.0f }, 0);
+    bench_collisions_spawn(start, 1, (Vector2){ -16.0f, area }, (Vector2){0}, (Rectangle){ 0, 0, area + 32.0f, 16.0f }, 0);
+    bench_collisions_spawn(start, 2, (Vector2){ -16.0f, 0.0f }, (Vector2){0}, (Rectangle){ 0, 0, 16.0f, area }, 0);
+    bench_collisions_spawn(start, 3, (Vector2){ area, 0.0f }, (Vector2){0}, (Rectangle){ 0, 0, 16.0f, area }, 0);
+    RandomState random = random_make(1, 0);
+    for(U64 ei = 4;
+            ei < BENCH_COLLISION_ENTITIES;
+            ei += 1)
+    {
+        Vector2 position = { random_f32(&random) * (area - 8.0f), random_f32(&random) * (area - 8.0f) };
+        Vector2 velocity = { (random_f32(&random) - 0.5f) * 1200.0f, (random_f32(&random) - 0.5f) * 1200.0f };
+        bench_collisions_spawn(start, ei, position, velocity, (Rectangle){ 0, 0, 8.0f, 8.0f }, 1);
+    }
+
+    Game *game = arena_push_array(arena, Game, 1);
+    U64 *hashes = arena_push_array(arena, U64, BENCH_COLLISION_TICKS);
+    Inputs inputs = {0};
+    F32 dt = 1.0f / 60.0f;
+    U64 cores = os_get_system_info()->logical_processor_count;
+    F64 serial_ms = 0.0;
+    int result = 0;
+    for(U64 workers = 1; // angn: 1, 2, 4, ... then every core
+            workers <= cores;
+            workers = (workers == cores || workers * 2 <= cores) ? workers * 2 : cores)
+    {
+        JobPool *pool = job_pool_make(arena, workers);
+        memcpy(game, start, sizeof(Game));
+
+        B32 identical = 1;
+        U64 start_time_us = os_now_microseconds();
+        for(U64 ti = 0;
+                ti < BENCH_COLLISION_TICKS;
+                ti += 1)
+        {
+            U64 arena_pos_tick = arena_pos(arena);
+            GameTickOutput output = { .arena = arena };
+            code->api.update(game, &pool->jobs, inputs, dt, &output);
+            U64 hash = bench_collisions_hash(game, &output);
+            arena_pop_to(arena, arena_pos_tick);
+            if(workers == 1) { hashes[ti] = hash; }
+            identical = identical && hashes[ti] == hash;
+        }
+        F64 tick_ms = Cast(F64, os_now_microseconds() - start_time_us) / 1000.0 / Cast(F64, BENCH_COLLISION_TICKS);
+        job_pool_release(pool);
+
+        if(workers == 1) { serial_ms = tick_ms; }
+        if(!identical) { result = 1; }
+        printf("BENCH: collisions %5llu entities %2llu workers: %.3fms per tick (%.2fx), %s\n",
+                Cast(unsigned long long, Cast(U64, BENCH_COLLISION_ENTITIES)),
+                Cast(unsigned long long, workers),
+                tick_ms,
+                tick_ms > 0.0 ? serial_ms / tick_ms : 0.0,
+                identical ? "same state as 1 worker" : "DIVERGED from 1 worker");
+    }
+    game_system_times_print(game, BENCH_COLLISION_TICKS); // angn: the last run, on every core
+    game_code_release(code);
+    return(result);
+}
+
+// angn: String8 keys shaped like asset paths, looked up through a linear scan,
+// a chained table and the HashMap, every one has to find the same values
+#define BENCH_HASH_LOOKUPS 65536
+
+HashMapDefineString8(bench_hash_ids, U32)
+
+typedef struct BenchHashNode BenchHashNode;
+struct BenchHashNode
+{
+    BenchHashNode *next;
+    String8 key;
+    U32 value;
+};
+
+internal int
+bench_hash_map(
+        Arena *arena)
+{
+    U64 counts[] = { 16, 256, 4096, 65536 };
+    RandomState random = random_make(1, 0);
+    int result = 0;
+    for(U64 ci = 0;
+            ci < StaticArrayLength(counts);
+            ci += 1)
+    {
+        U64 count = counts[ci];
+        U64 arena_pos_start = arena_pos(arena);
+
+        //- angn: keys, and the order they get looked up in
+        String8 *keys = arena_push_array(arena, String8, count);
+        for(U64 ki = 0;
+                ki < count;
+                ki += 1)
+        {
+            keys[ki] = string8_push_fmt(arena, "textures/entity_%llu.png", Cast(unsigned long long, ki * 7919));
+        }
+        String8 *missing = arena_push_array(arena, String8, count);
+        for(U64 ki = 0;
+                ki < count;
+                ki += 1)
+        {
+            missing[ki] = string8_push_fmt(arena, "textures/entity_%llu.png", Cast(unsigned long long, ki * 7919 + 1));
+        }
+        U32 *lookups = arena_push_array_no_zero(arena, U32, BENCH_HASH_LOOKUPS);
+        random_fill_u32_bounded(&random, lookups, BENCH_HASH_LOOKUPS, Cast(U32, count));
+
+        //- angn: linear scan, capped so the big sizes finish
+        U64 linear_lookups = Min(BENCH_HASH_LOOKUPS, (1ull << 24) / count);
+        U64 linear_sum = 0;
+        U64 start_time_us = os_now_microseconds();
+        for(U64 li = 0;
+                li < linear_lookups;
+                li += 1)
+        {
+            String8 key = keys[lookups[li]];
+            for(U64 ki = 0;
+                    ki < count;
+                    ki += 1)
+            {
+                if(string8_match(keys[ki], key))
+                {
+                    linear_sum += ki;
+                    break;
+                }
+            }
+        }
+        F64 linear_ns = Cast(F64, os_now_microseconds() - start_time_us) * 1000.0 / Cast(F64, linear_lookups);
+
+        //- angn: chained, one node per key
+        U64 buckets_count = hash_map_capacity_for(count);
+        BenchHashNode **buckets = arena_push_array(arena, BenchHashNode *, buckets_count);
+        BenchHashNode *nodes = arena_push_array(arena, BenchHashNode, count);
+        for(U64 ki = 0;
+                ki < count;
+                ki += 1)
+        {
+            BenchHashNode *node = &nodes[ki];
+            node->key = keys[ki];
+            node->value = Cast(U32, ki);
+            U64 bucket = string8_hash(keys[ki]) & (buckets_count - 1);
+            SLLStackPush_N(buckets[bucket], node, next);
+        }
+        U64 chained_sum = 0;
+        U64 chained_lookups_sum = 0;
+        start_time_us = os_now_microseconds();
+        for(U64 li = 0;
+                li < BENCH_HASH_LOOKUPS;
+                li += 1)
+        {
+            String8 key = keys[lookups[li]];
+            for(BenchHashNode *node = buckets[string8_hash(key) & (buckets_count - 1)];
+                    node != 0;
+                    node = node->next)
+            {
+                if(string8_match(node->key, key))
+                {
+                    chained_lookups_sum += node->value;
+                    if(li < linear_lookups) { chained_sum += node->value; }
+                    break;
+                }
+            }
+        }
+        F64 chained_ns = Cast(F64, os_now_microseconds() - start_time_us) * 1000.0 / Cast(F64, BENCH_HASH_LOOKUPS);
+
+        U64 chained_misses = 0;
+        start_time_us = os_now_microseconds();
+        for(U64 li = 0;
+                li < BENCH_HASH_LOOKUPS;
+                li += 1)
+        {
+            String8 key = missing[lookups[li]];
+            BenchHashNode *node = buckets[string8_hash(key) & (buckets_count - 1)];
+            for(;
+                    node != 0 && !string8_match(node->key, key);
+                    node = node->next)
+            {
+            }
+            chained_misses += node == 0;
+        }
+        F64 chained_miss_ns = Cast(F64, os_now_microseconds() - start_time_us) * 1000.0 / Cast(F64, BENCH_HASH_LOOKUPS);
+
+        //- angn: HashMap
+        HashMap map = bench_hash_ids_make(arena, count);
+        for(U64 ki = 0;
+                ki < count;
+                ki += 1)
+        {
+            *bench_hash_ids_insert(&map, keys[ki], 0) = Cast(U32, ki);
+        }
+        U64 map_sum = 0;
+        U64 map_lookups_sum = 0;
+        start_time_us = os_now_microseconds();
+        for(U64 li = 0;
+                li < BENCH_HASH_LOOKUPS;
+                li += 1)
+        {
+            U32 *value = bench_hash_ids_lookup(&map, keys[lookups[li]]);
+            if(value)
+            {
+                map_lookups_sum += *value;
+                if(li < linear_lookups) { map_sum += *value; }
+            }
+        }
+        F64 map_ns = Cast(F64, os_now_microseconds() - start_time_us) * 1000.0 / Cast(F64, BENCH_HASH_LOOKUPS);
+
+        U64 map_misses = 0;
+        start_time_us = os_now_microseconds();
+        for(U64 li = 0;
+                li < BENCH_HASH_LOOKUPS;
+                li += 1)
+        {
+            map_misses += bench_hash_ids_lookup(&map, missing[lookups[li]]) == 0;
+        }
+        F64 map_miss_ns = Cast(F64, os_now_microseconds() - start_time_us) * 1000.0 / Cast(F64, BENCH_HASH_LOOKUPS);
+
+        //- angn: remove every other key, the rest must still be found and nothing else
+        U64 iterated = 0;
+        for(U64 ki = 0;
+                ki < count;
+                ki += 2)
+        {
+            bench_hash_ids_remove(&map, keys[ki]);
+        }
+        B32 removed_ok = map.count == count / 2;
+        for(U64 ki = 0;
+                ki < count;
+                ki += 1)
+        {
+            U32 *value = bench_hash_ids_lookup(&map, keys[ki]);
+            removed_ok = removed_ok && ((ki & 1) ? (value && *value == ki) : value == 0);
+        }
+        for(HashMapIterator it = hash_map_iterator_make(&map);
+                hash_map_iterator_next(&it);)
+        {
+            iterated += 1;
+        }
+        removed_ok = removed_ok && iterated == count / 2;
+
+        B32 identical = linear_sum == chained_sum && linear_sum == map_sum && chained_lookups_sum == map_lookups_sum &&
+            chained_misses == BENCH_HASH_LOOKUPS && map_misses == BENCH_HASH_LOOKUPS;
+        if(!identical || !removed_ok) { result = 1; }
+        printf("BENCH: hash map %5llu keys: linear %.1fns, chained %.1fns hit %.1fns miss, hash map %.1fns hit %.1fns miss per lookup, %s\n",
+                Cast(unsigned long long, count),
+                linear_ns,
+                chained_ns,
+                chained_miss_ns,
+                map_ns,
+                map_miss_ns,
+                (identical && removed_ok) ? "same values" : "MISMATCH");
+
+        arena_pop_to(arena, arena_pos_start);
+    }
+    return(result);
+}
+
+//~ angn: Sweep cases
+// angn: high-speed cases the swept collision has to get right, run headless
+// with --sweep-cases, a step of 1000px and more against walls 0 or 1px thick
+#define SWEEP_CASE_TOLERANCE 0.01f
+
+typedef struct SweepCase SweepCase;
+struct SweepCase
+{
+    char *name;
+    Rectangle box;
+    Vector2 velocity;
+    B32 bounce;
+    Rectangle obstacles[2];
+    U64 obstacles_count;
+    Vector2 expected_delta;
+    Vector2 expected_velocity;
+};
+
+internal int
+sweep_cases_run(void)
+{
+    F32 dt = 1.0f / 60.0f;
+    SweepCase cases[] =
+    {
+        { "thin wall, slide", { 0, 0, 8, 8 }, { 60000, 0 }, 0, { { 500, -50, 1, 100 } }, 1, { 492, 0 }, { 0, 0 } },
+        { "zero thickness wall", { 0, 0, 8, 8 }, { 60000, 0 }, 0, { { 500, -50, 0, 100 } }, 1, { 492, 0 }, { 0, 0 } },
+        { "thin wall, bounce", { 0, 0, 8, 8 }, { 60000, 0 }, 1, { { 500, -50, 1, 100 } }, 1, { -16, 0 }, { -60000, 0 } },
+        { "diagonal, slides down the wall", { 0, 0, 8, 8 }, { 60000, 60000 }, 0, { { 500, -1000, 1, 2000 } }, 1, { 492, 1000 }, { 0, 60000 } },
+        { "diagonal into a corner", { 0, 0, 8, 8 }, { 60000, 60000 }, 0, { { 500, -1000, 1, 2000 }, { -1000, 600, 2000, 1 } }, 2, { 492, 592 }, { 0, 0 } },
+        { "nearest of two walls", { 0, 0, 8, 8 }, { 60000, 0 }, 0, { { 500, -50, 1, 100 }, { 300, -50, 1, 100 } }, 2, { 292, 0 }, { 0, 0 } },
+        { "passes above the wall", { 0, -100, 8, 8 }, { 60000, 0 }, 0, { { 500, -50, 1, 100 } }, 1, { 1000, 0 }, { 60000, 0 } },
+        { "grazes the wall corner", { 0, -58, 8, 8 }, { 60000, 0 }, 0, { { 500, -50, 1, 100 } }, 1, { 1000, 0 }, { 60000, 0 } },
+        { "1e6 px/s", { 0, 0, 8, 8 }, { 1000000, 0 }, 0, { { 10000, -50, 1, 100 } }, 1, { 9992, 0 }, { 0, 0 } },
+        { "resting against the wall", { 492, 0, 8, 8 }, { 600, 0 }, 0, { { 500, -50, 1, 100 } }, 1, { 0, 0 }, { 0, 0 } },
+        { "sliding along the wall", { 492, 0, 8, 8 }, { 0, 600 }, 0, { { 500, -50, 1, 100 } }, 1, { 0, 10 }, { 0, 600 } },
+        { "leaves the box it started in", { 0, 0, 8, 8 }, { 600, 0 }, 0, { { 0, 0, 32, 32 } }, 1, { 10, 0 }, { 600, 0 } },
+        { "moving away from the wall", { 492, 0, 8, 8 }, { -60000, 0 }, 0, { { 500, -50, 1, 100 } }, 1, { -1000, 0 }, { -60000, 0 } },
+    };
+
+    U64 failed = 0;
+    for(U64 ci = 0;
+            ci < StaticArrayLength(cases);
+            ci += 1)
+    {
+        SweepCase *c = &cases[ci];
+        SweepResult result = sweep_move(c->box, c->velocity, dt, c->obstacles, c->obstacles_count, c->obstacles_count, c->bounce);
+        B32 ok = (fabsf(result.delta.x - c->expected_delta.x) <= SWEEP_CASE_TOLERANCE &&
+                fabsf(result.delta.y - c->expected_delta.y) <= SWEEP_CASE_TOLERANCE &&
+                fabsf(result.velocity.x - c->expected_velocity.x) <= SWEEP_CASE_TOLERANCE &&
+                fabsf(result.velocity.y - c->expected_velocity.y) <= SWEEP_CASE_TOLERANCE);
+        if(!ok)
+        {
+            failed += 1;
+        }
+        printf("SWEEP: %s %s: delta (%.3f, %.3f) velocity (%.3f, %.3f), expected (%.3f, %.3f) (%.3f, %.3f)\n",
+                ok ? "ok  " : "FAIL",
+                c->name,
+                result.delta.x, result.delta.y,
+                result.velocity.x, result.velocity.y,
+                c->expected_delta.x, c->expected_delta.y,
+                c->expected_velocity.x, c->expected_velocity.y);
+    }
+    printf("SWEEP: %llu of %llu cases failed\n",
+            Cast(unsigned long long, failed),
+            Cast(unsigned long long, StaticArrayLength(cases)));
+    return(failed ? 1 : 0);
+}
+
+//~ angn: Math tests
+// angn: every batch kernel (pound.c and the motion ones) against its scalar version, run headless
+// with --math-tests. counts straddle every lane width (and 0), boxes come off
+// a coarse grid so touching edges are common, out is checked past count too.
+// floats are compared bit for bit, build.sh turns multiply-add fusing off
+#define MATH_TEST_ROUNDS    16
+#define MATH_TEST_SENTINEL  12345.0f
+
+global U64 math_test_counts[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 67 };
+
+internal B32
+math_test_f32_same(
+        F32 a,
+        F32 b)
+{
+    return(memcmp(&a, &b, sizeof(F32)) == 0);
+}
+
+internal F32
+math_test_f32(
+        RandomState *random)
+{
+    return((random_f32(random) - 0.5f) * 2000.0f);
+}
+
+internal U64
+math_test_vec2(
+        Arena *arena,
+        RandomState *random,
+        U32 kernel, // angn: 0 add, 1 scale, 2 rotate, 3 add in place
+        U64 count)
+{
+    U64 mismatches = 0;
+    TempArena temp = temp_arena_begin(arena);
+    Vec2F32 *a = arena_push_array(temp.arena, Vec2F32, count + 1);
+    Vec2F32 *b = arena_push_array(temp.arena, Vec2F32, count + 1);
+    Vec2F32 *out = arena_push_array(temp.arena, Vec2F32, count + 1);
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        a[i] = vec2f32_make(math_test_f32(random), math_test_f32(random));
+        b[i] = vec2f32_make(math_test_f32(random), math_test_f32(random));
+    }
+    out[count] = vec2f32_make(MATH_TEST_SENTINEL, MATH_TEST_SENTINEL);
+    F32 s = math_test_f32(random) * 0.01f;
+
+    switch(kernel)
+    {
+    case 0: { vec2f32_add_batch(out, a, b, count); } break;
+    case 1: { vec2f32_scale_batch(out, a, s, count); } break;
+    case 2: { vec2f32_rotate_batch(out, a, s, count); } break;
+    case 3:
+    {
+        memcpy(out, a, sizeof(Vec2F32) * count);
+        vec2f32_add_batch(out, out, b, count);
+    } break;
+    }
+
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        Vec2F32 expected = {0};
+        switch(kernel)
+        {
+        case 0: case 3: { expected = vec2f32_add(a[i], b[i]); } break;
+        case 1: { expected = vec2f32_scale(a[i], s); } break;
+        case 2: { expected = vec2f32_rotate(a[i], s); } break;
+        }
+        if(!math_test_f32_same(out[i].x, expected.x) || !math_test_f32_same(out[i].y, expected.y))
+        {
+            mismatches += 1;
+        }
+    }
+    if(out[count].x != MATH_TEST_SENTINEL || out[count].y != MATH_TEST_SENTINEL)
+    {
+        mismatches += 1;
+    }
+    temp_arena_end(temp);
+    return(mismatches);
+}
+
+internal U64
+math_test_overlaps(
+        Arena *arena,
+        RandomState *random,
+        U64 count)
+{
+    U64 mismatches = 0;
+    TempArena temp = temp_arena_begin(arena);
+    Range2F32 *a = arena_push_array(temp.arena, Range2F32, count + 1);
+    Range2F32 *b = arena_push_array(temp.arena, Range2F32, count + 1);
+    B8 *out = arena_push_array(temp.arena, B8, count + 1);
+
+    // angn: corners on a 4x4 grid, so boxes touch, nest, coincide and collapse to zero size
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        Range2F32 *boxes[2] = { &a[i], &b[i] };
+        for(U64 bi = 0;
+                bi < 2;
+                bi += 1)
+        {
+            F32 x0 = Cast(F32, random_u32_bounded(random, 4));
+            F32 y0 = Cast(F32, random_u32_bounded(random, 4));
+            *boxes[bi] = (Range2F32){ .min = vec2f32_make(x0, y0), .max = vec2f32_make(x0 + Cast(F32, random_u32_bounded(random, 3)), y0 + Cast(F32, random_u32_bounded(random, 3))) };
+        }
+    }
+    out[count] = 7;
+
+    range2f32_overlaps_batch(out, a, b, count);
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        if(out[i] != Cast(B8, range2f32_overlaps(a[i], b[i])))
+        {
+            mismatches += 1;
+        }
+    }
+    if(out[count] != 7)
+    {
+        mismatches += 1;
+    }
+    temp_arena_end(temp);
+    return(mismatches);
+}
+
+// angn: the cases that have to come out right, whatever the random ones do
+internal U64
+math_test_overlaps_edges(void)
+{
+    Range2F32 a[] =
+    {
+        { .min = { 0, 0 }, .max = { 1, 1 } }, // angn: shares the right edge
+        { .min = { 0, 0 }, .max = { 1, 1 } }, // angn: shares the bottom edge
+        { .min = { 0, 0 }, .max = { 1, 1 } }, // angn: shares a corner
+        { .min = { 0, 0 }, .max = { 1, 1 } }, // angn: the same box
+        { .min = { 0, 0 }, .max = { 4, 4 } }, // angn: contains the other
+        { .min = { 0.5f, 0.5f }, .max = { 0.5f, 0.5f } }, // angn: zero size, strictly inside
+        { .min = { 1, 0.5f }, .max = { 1, 0.5f } }, // angn: zero size, on the edge
+        { .min = { -2, -2 }, .max = { -1, -1 } }, // angn: apart
+    };
+    Range2F32 b[] =
+    {
+        { .min = { 1, 0 }, .max = { 2, 1 } },
+        { .min = { 0, 1 }, .max = { 1, 2 } },
+        { .min = { 1, 1 }, .max = { 2, 2 } },
+        { .min = { 0, 0 }, .max = { 1, 1 } },
+        { .min = { 1, 1 }, .max = { 2, 2 } },
+        { .min = { 0, 0 }, .max = { 1, 1 } },
+        { .min = { 0, 0 }, .max = { 1, 1 } },
+        { .min = { 1, 1 }, .max = { 2, 2 } },
+    };
+    B8 expected[] = { 0, 0, 0, 1, 1, 1, 0, 0 };
+
+    B8 out[StaticArrayLength(a)] = {0};
+    range2f32_overlaps_batch(out, a, b, StaticArrayLength(a));
+    U64 mismatches = 0;
+    for(U64 i = 0;
+            i < StaticArrayLength(a);
+            i += 1)
+    {
+        if(out[i] != expected[i] || Cast(B8, range2f32_overlaps(a[i], b[i])) != expected[i])
+        {
+            mismatches += 1;
+        }
+    }
+    return(mismatches);
+}
+
+internal U64
+math_test_transform(
+        Arena *arena,
+        RandomState *random,
+        U64 count)
+{
+    U64 mismatches = 0;
+    TempArena temp = temp_arena_begin(arena);
+    Vec4F32 *in = arena_push_array(temp.arena, Vec4F32, count + 1);
+    Vec4F32 *out = arena_push_array(temp.arena, Vec4F32, count + 1);
+    Mat4x4F32 m = {0};
+    for(U64 r = 0;
+            r < 4;
+            r += 1)
+    {
+        for(U64 c = 0;
+                c < 4;
+                c += 1)
+        {
+            m.v[r][c] = math_test_f32(random) * 0.001f;
+        }
+    }
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        in[i] = (Vec4F32){ .x = math_test_f32(random), .y = math_test_f32(random), .z = math_test_f32(random), .w = 1.0f };
+    }
+    out[count] = (Vec4F32){ .x = MATH_TEST_SENTINEL, .y = MATH_TEST_SENTINEL, .z = MATH_TEST_SENTINEL, .w = MATH_TEST_SENTINEL };
+
+    mat4x4f32_transform_batch(out, m, in, count);
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        Vec4F32 expected = mat4x4f32_mul_vec4f32(m, in[i]);
+        for(U64 k = 0;
+                k < 4;
+                k += 1)
+        {
+            if(!math_test_f32_same(out[i].v[k], expected.v[k]))
+            {
+                mismatches += 1;
+                break;
+            }
+        }
+    }
+    for(U64 k = 0;
+            k < 4;
+            k += 1)
+    {
+        if(out[count].v[k] != MATH_TEST_SENTINEL)
+        {
+            mismatches += 1;
+            break;
+        }
+    }
+    temp_arena_end(temp);
+    return(mismatches);
+}
+
+// angn: the motion kernels promise the same bits as their scalar versions,
+// state hashes and worker counts rely on it, so these compare exactly
+internal U64
+math_test_motion(
+        Arena *arena,
+        RandomState *random,
+        U32 kernel, // angn: 0 friction, 1 integrate
+        U64 count)
+{
+    U64 mismatches = 0;
+    TempArena temp = temp_arena_begin(arena);
+    F32 *arrays[2][4] = {0}; // angn: [scalar, wide][position_x, position_y, velocity_x, velocity_y]
+    F32 *scale = arena_push_array(temp.arena, F32, count + 1);
+    for(U64 ai = 0;
+            ai < 4;
+            ai += 1)
+    {
+        arrays[0][ai] = arena_push_array(temp.arena, F32, count + 1);
+        arrays[1][ai] = arena_push_array(temp.arena, F32, count + 1);
+        for(U64 i = 0;
+                i < count;
+                i += 1)
+        {
+            arrays[0][ai][i] = math_test_f32(random);
+        }
+        arrays[0][ai][count] = MATH_TEST_SENTINEL;
+        memcpy(arrays[1][ai], arrays[0][ai], sizeof(F32) * (count + 1));
+    }
+    // angn: a flag that is off is a 0 lane, the rest look like friction * dt or dt
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        scale[i] = random_u32_bounded(random, 4) == 0 ? 0.0f : random_f32(random) * 0.25f;
+    }
+
+    if(kernel == 0)
+    {
+        motion_apply_friction_scalar(arrays[0][2], arrays[0][3], scale, count);
+        motion_apply_friction(arrays[1][2], arrays[1][3], scale, count);
+    }
+    else
+    {
+        motion_integrate_scalar(arrays[0][0], arrays[0][1], arrays[0][2], arrays[0][3], scale, count);
+        motion_integrate(arrays[1][0], arrays[1][1], arrays[1][2], arrays[1][3], scale, count);
+    }
+
+    for(U64 ai = 0;
+            ai < 4;
+            ai += 1)
+    {
+        for(U64 i = 0;
+                i < count + 1;
+                i += 1)
+        {
+            if(memcmp(&arrays[0][ai][i], &arrays[1][ai][i], sizeof(F32)) != 0)
+            {
+                mismatches += 1;
+            }
+        }
+    }
+    temp_arena_end(temp);
+    return(mismatches);
+}
+
+internal int
+math_tests_run(
+        Arena *arena)
+{
+    char *kernels[] =
+    {
+        "vec2f32_add_batch",
+        "vec2f32_scale_batch",
+        "vec2f32_rotate_batch",
+        "vec2f32_add_batch in place",
+        "range2f32_overlaps_batch",
+        "mat4x4f32_transform_batch",
+        "motion_apply_friction",
+        "motion_integrate",
+    };
+
+    RandomState random = random_make(1, 0);
+    U64 failed = 0;
+    for(U32 ki = 0;
+            ki < StaticArrayLength(kernels);
+            ki += 1)
+    {
+        U64 mismatches = 0;
+        U64 checked = 0;
+        for(U64 round = 0;
+                round < MATH_TEST_ROUNDS;
+                round += 1)
+        {
+            for(U64 ci = 0;
+                    ci < StaticArrayLength(math_test_counts);
+                    ci += 1)
+            {
+                U64 count = math_test_counts[ci];
+                switch(ki)
+                {
+                case 0: case 1: case 2: case 3: { mismatches += math_test_vec2(arena, &random, ki, count); } break;
+                case 4: { mismatches += math_test_overlaps(arena, &random, count); } break;
+                case 5: { mismatches += math_test_transform(arena, &random, count); } break;
+                case 6: case 7: { mismatches += math_test_motion(arena, &random, ki - 6, count); } break;
+                }
+                checked += count;
+            }
+        }
+        if(ki == 4)
+        {
+            mismatches += math_test_overlaps_edges();
+        }
 
-    for(U64 ei = 0;
-            ei < ENTITIES_CAPACITY;
-            ei += 1)
-    {
-        Entity *entity = &game->entities[ei];
-        if(!entity_flags_contains(&entity->flags, EntityFlagsIndex_Alive)
-                || entity->handle.gen == 0)
+        if(mismatches)
         {
-            continue;
+            failed += 1;
         }
+        printf("MATH: %s %s: %llu elements, %llu mismatches\n",
+                mismatches ? "FAIL" : "ok  ",
+                kernels[ki],
+                Cast(unsigned long long, checked),
+                Cast(unsigned long long, mismatches));
+    }
+    printf("MATH: %llu of %llu kernels failed\n",
+            Cast(unsigned long long, failed),
+            Cast(unsigned long long, StaticArrayLength(kernels)));
+    return(failed ? 1 : 0);
+}
 
-        // angn: should we feature flag this?
-        entity->animations[entity->player_state].frame_duration++;
+//~ angn: Simulation thread
+typedef enum : U64
+{
+    SimulationRequest_None,
+    SimulationRequest_Save,
+    SimulationRequest_Load,
+    SimulationRequest_Rewind,
+} SimulationRequest;
+
+typedef struct Simulation Simulation;
+struct Simulation
+{
+    Game *game;
+    GameCode *code;
+    JobPool *pool;
+    Arena *scratch;
+    Arena *persist; // angn: frames of loaded snapshots
+    ReplayRecorder *recorder; // angn: 0 unless recording
+    StateHashStream *hashes; // angn: 0 unless hashing
+    GameSnapshotRing snapshot_ring;
+    F32 dt_fixed;
+
+    InputQueue input_queue;
+    SoundEventQueue sound_event_queue;
+    RenderSnapshotBuffer *snapshots;
+
+    //- angn: set by the main thread, read atomically
+    U64 screen; // angn: x in the high half, y in the low half
+    U64 playing;
+    U64 quit;
+    U64 request; // angn: SimulationRequest, taken between ticks
+};
 
-        // nick: velocity we started the frame with
-        Vector2 initial_velocity = entity->velocity;
-        Entity *collided_with = 0;
+internal void
+simulation_thread_entry(
+        void *params)
+{
+    Simulation *sim = (Simulation *)params;
+    Game *game = sim->game;
+    F32 dt_fixed = sim->dt_fixed;
 
-        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_WASDMotion))
-        {
-            Vector2 dir = {0};
+    U64 tick = 0;
+    Inputs inputs = {0};
+    F32 time_accumulator = 0.0f; // carry any extra-time(under-updates) past the frame
+    U64 current_time = os_now_microseconds();
 
-            PlayerState old_state = entity->player_state;
+    for(;!AtomicLoadU64(&sim->quit);)
+    {
+        //- angn: fixed time
+        U64 new_time = os_now_microseconds();
+        F32 frame_time = Cast(F32, new_time - current_time) / 1000000.0f;
+        current_time = new_time;
 
-            // daria: NOTE: this assumes it's a player
-            // daria: TODO: determine entity type
-            if(inputs[InputTypes_W] & InputState_Down)
-            {
-                dir.y -= 1.0f;
-                entity->player_state = PlayerState_Up;
-            }
-            if(inputs[InputTypes_S] & InputState_Down)
-            {
-                dir.y += 1.0f;
-                entity->player_state = PlayerState_Down;
-            }
-            if(inputs[InputTypes_D] & InputState_Down)
-            {
-                dir.x += 1.0f;
-                entity->player_state = PlayerState_Right;
-            }
-            if(inputs[InputTypes_A] & InputState_Down)
-            {
-                dir.x -= 1.0f;
-                entity->player_state = PlayerState_Left;
-            }
+        frame_time = Min(0.25f, frame_time); // angn: restrict number of updates
+                                             // so we don't do an update death spiral
+        time_accumulator += frame_time;
 
-            if(dir.x == 0.0f && dir.y == 0.0f)
+        //- angn: pick up a rebuilt game library, `game` carries over untouched
+        // angn: NOTE: only ever between ticks, nothing is running the old code
+        game_code_load(sim->code, sim->scratch);
+
+        //- angn: snapshots the main thread asked for
+        switch(AtomicExchangeU64(&sim->request, SimulationRequest_None))
+        {
+        case SimulationRequest_Save:
+        {
+            B32 saved = game_snapshot_save(sim->scratch, game, string8_from_cstring(GAME_SNAPSHOT_PATH));
+            printf("INFO: SNAPSHOT: %s %s\n", saved ? "saved" : "failed to save", GAME_SNAPSHOT_PATH);
+        } break;
+        // angn: NOTE: a recording only holds inputs, jumping the state under it
+        // would make it replay something else
+        case SimulationRequest_Load:
+        {
+            if(sim->recorder)
             {
-                entity->player_state = PlayerState_Idle;
+                printf("INFO: SNAPSHOT: not loading while recording\n");
             }
-
-            if(old_state != entity->player_state)
+            else
             {
-                entity->animations[old_state].frame_duration = 0;
+                B32 loaded = game_snapshot_load(sim->persist, sim->scratch, game, string8_from_cstring(GAME_SNAPSHOT_PATH));
+                printf("INFO: SNAPSHOT: %s %s\n", loaded ? "loaded" : "failed to load", GAME_SNAPSHOT_PATH);
             }
-
-            dir = Vector2ClampValue(dir, 0.0f, 1.0f);
-
-            if(entity_flags_contains(&entity->flags, EntityFlagsIndex_ApplyFriction))
+        } break;
+        case SimulationRequest_Rewind:
+        {
+            if(sim->recorder)
             {
-                entity->velocity =
-                    Vector2Add(
-                            entity->velocity,
-                            Vector2Scale(dir, entity->friction * 1000.0f * dt));
+                printf("INFO: SNAPSHOT: not rewinding while recording\n");
             }
             else
             {
-                entity->velocity =
-                    Vector2Add(
-                            entity->velocity,
-                            Vector2Scale(dir, 1000.0f * dt));
+                game_snapshot_ring_rewind(&sim->snapshot_ring, game);
             }
+        } break;
         }
 
-        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_ApplyFriction))
-        {
-            entity->velocity =
-                Vector2Add(
-                        entity->velocity,
-                        Vector2Scale(initial_velocity, -(entity->friction * dt)));
-        }
+        //- angn: get information
+        U64 screen = AtomicLoadU64(&sim->screen);
+        game->screen.x = Cast(S32, screen >> 32);
+        game->screen.y = Cast(S32, screen & 0xffffffff);
 
-        // angn: TODO: this is just an example
-        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_ShootOnClick))
+        //- angn: update
+        B32 playing = Cast(B32, AtomicLoadU64(&sim->playing));
+        B32 ticked = 0;
+        for(;
+                time_accumulator > dt_fixed;
+                time_accumulator -= dt_fixed)
         {
-            if(inputs[InputTypes_Shoot] & InputState_Pressed) {
-                game->spell_construction.slot_index = 0;
-                game->new_spell = 1;
-
-                PlaySound(entity->sound_effects[EventType_Shoot]);
-
-                Entity *spell = alloc_entity(game);
-                Assert(spell);
-                spell->position = entity->position;
-                spell->velocity = entity->velocity;
-                spell->friction = 1.0f;
-                spell->spell_data = game->spell_construction;
-                spell->spell_data.rotation = Vector2Angle((Vector2){1.0f, 0.0f}, spell->velocity);
-
-                switch(game->spell_construction.type)
+            //- angn: get inputs, only what happened before the end of this tick
+            // angn: Down/Up are levels, Pressed/Released stick until a tick has seen them
+            // angn: NOTE: a second press (or release) of a key waits for the next
+            // tick instead of merging into this one, and keeps the events behind it waiting too
+            U64 tick_end_us = new_time - Cast(U64, (time_accumulator - dt_fixed) * 1000000.0f);
+            for(InputEvent event = {0};
+                    input_queue_peek(&sim->input_queue, &event);)
+            {
+                InputState edges = event.state & inputs[event.type] & (InputState_Pressed | InputState_Released);
+                if(event.time_us > tick_end_us || edges)
                 {
-                default:
-                    puts("hi :3");
                     break;
-
-                case SpellType_Bomb:
-                {
-                    spell->spell_data.lifetime = spell->spell_data.program_length;
-                    spell->spell_data.ticks_per_step = 30; // 0.5sec : step
-                } break;
-
-                case SpellType_Bolt:
-                {
-                    spell->spell_data.lifetime = spell->spell_data.program_length * 2;
-                    spell->spell_data.ticks_per_step = 15; // 0.25sec : step
-                } break;
-
-                case SpellType_Loop_Bolt:
-                {
-                    spell->spell_data.lifetime = spell->spell_data.program_length * 5;
-                    spell->spell_data.ticks_per_step = 15; // 0.3sec : step
-                } break;
-
-                case SpellType_Bounce_Bolt:
-                {
-                    spell->spell_data.lifetime = spell->spell_data.program_length * 10;
-                    spell->spell_data.ticks_per_step = 6; // 0.1sec : step
-                } break;
                 }
-
-                entity_flags_set(&spell->flags, EntityFlagsIndex_Spell);
-                entity_flags_set(&spell->flags, EntityFlagsIndex_ApplyVelocity);
-                entity_flags_set(&spell->flags, EntityFlagsIndex_ApplyFriction);
-
-                game->spell_construction = (SpellData){0};
-                game->spell_construction.program_index = (game->spell_construction.program_index + 1) % SPELL_PROGRAMS_MAX;
+                input_queue_pop(&sim->input_queue, &event);
+                inputs[event.type] = (inputs[event.type] & (InputState_Pressed | InputState_Released)) | event.state;
             }
-        }
 
-        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_Spell))
-        {
-            if(entity->spell_data.tick >= entity->spell_data.ticks_per_step)
+            if(playing)
             {
-                entity->spell_data.tick = 0;
-                entity->spell_data.lifetime--;
-
-                SpellInstruction next = game->spell_programs
-                        [entity->spell_data.program_index]
-                        [entity->spell_data.slot_index];
-
-                entity->spell_data.slot_index = (entity->spell_data.slot_index + 1) % entity->spell_data.program_length;
-
-                switch(next)
-                {
-                default: {} break;
-                case SpellInstruction_Accel_Forward:
-                {
-                    entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){1.0f, 0.0f}, entity->spell_data.rotation), 100.0f));
-                    puts("fwd");
-                } break;
-                case SpellInstruction_Accel_Left:
-                {
-                    entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){0.0f, -1.0f}, entity->spell_data.rotation), 100.0f));
-                    puts("left");
-                } break;
-                case SpellInstruction_Accel_Right:
-                {
-                    entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){0.0f, -1.0f}, entity->spell_data.rotation), 100.0f));
-                    puts("right");
-                } break;
-                case SpellInstruction_Accel_Back:
-                {
-                    entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){-1.0f, 0.0f}, entity->spell_data.rotation), 100.0f));
-                    puts("back");
-                } break;
-                case SpellInstruction_Turn_Left:
-                {
-                    entity->spell_data.rotation += (30.0f / 180.0f) * PI;
-                    puts("turn left");
-                } break;
-                case SpellInstruction_Turn_Right:
-                {
-                    entity->spell_data.rotation -= (30.0f / 180.0f) * PI;
-                    puts("turn right");
-                } break;
-                case SpellInstruction_Turn_About:
-                {
-                    entity->spell_data.rotation += PI;
-                    puts("turn about");
-                } break;
-                case SpellInstruction_Face_Enemy:
-                {
-                } break;
-                case SpellInstruction_Face_Player:
-                {
-                    // for(
-                    //         U64 i = 0;
-                    //         i < ENTITIES_CAPACITY;
-                    //         i++)
-                    // {
-                    //     if(entity_flags_contains(&entity->flags, EntityFlagsIndex_Player)) {
-                    //     }
-                    // }
-                } break;
-                case SpellInstruction_Abeam_Enemy:
-                {
-                } break;
-                case SpellInstruction_Abeam_Player:
-                {
-                } break;
+                if(sim->recorder) { replay_record(sim->recorder, inputs); }
+                sim->code->api.update(game, &sim->pool->jobs, inputs, dt_fixed, 0);
+                if(sim->hashes) { state_hash_stream_push(sim->hashes, game); }
+                tick += 1;
+                ticked = 1;
 
-                //~ nick: utility spells
-                case SpellInstruction_Duplicate:
+                if(tick % GAME_SNAPSHOT_RING_INTERVAL == 0)
                 {
-                } break;
-                case SpellInstruction_Death_Duplicate:
-                {
-                } break;
-                case SpellInstruction_Burst_Duplicate:
-                {
-                } break;
-                case SpellInstruction_Increase_Lifetime:
-                {
-                } break;
-                case SpellInstruction_Decrease_Lifetime:
-                {
-                } break;
-                case SpellInstruction_Destroy_Spell:
-                {
-                } break;
-                case SpellInstruction_Increase_Execution_Speed:
-                {
-                } break;
-                case SpellInstruction_Decrease_Execution_Speed:
-                {
-                } break;
-                case SpellInstruction_Loop:
-                {
-                } break;
+                    game_snapshot_ring_take(&sim->snapshot_ring, game);
+                }
 
-                //~ nick: effect spells
-                case SpellInstruction_Arm_Pierce:
-                {
-                } break;
-                case SpellInstruction_Arm_Explode:
-                {
-                } break;
-                case SpellInstruction_Do_Sear:
-                {
-                } break;
-                case SpellInstruction_Do_Flameburst:
+                // angn: NOTE: dropped if the main thread is far behind, stale sounds are useless
+                for(U64 si = 0;
+                        si < game->sound_events_count;
+                        si += 1)
                 {
-                } break;
+                    sound_event_queue_push(&sim->sound_event_queue, game->sound_events[si]);
                 }
+                game->sound_events_count = 0;
             }
 
-            if(entity->spell_data.lifetime <= 0) {
-                entity_flags_unset(&entity->flags, EntityFlagsIndex_Alive);
-                puts("die");
+            //- angn: unset the pressed and released flags
+            for(InputTypes ki = 0;
+                    ki < InputTypes__Count;
+                    ki += 1)
+            {
+                inputs[ki] &= ~(InputState_Pressed | InputState_Released);
             }
-
-            entity->spell_data.tick++;
-
         }
 
-        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_ApplyVelocity))
+        //- angn: publish
+        if(ticked)
         {
-            if(entity_flags_contains(&entity->flags, EntityFlagsIndex_Collider))
-            {
-
-                for(U64 ci = 0;
-                        ci < ENTITIES_CAPACITY;
-                        ci += 1)
-                {
-                    Entity *other = &game->entities[ci];
-
-                    // do not self-intersect.
-                    if(entity == other)
-                    {
-                        continue;
-                    }
-                    // not of concern
-                    if(!entity_flags_contains(&other->flags, EntityFlagsIndex_Alive)
-                                || !entity_flags_contains(&other->flags, EntityFlagsIndex_Collider))
-                    {
-                        continue;
-                    }
-
-                    Rectangle entity_box =
-                    {
-                        entity->position.x + entity->collision.x + entity->velocity.x * dt,
-                        entity->position.y + entity->collision.y + entity->velocity.y * dt,
-                        entity->collision.width,
-                        entity->collision.height
-                    };
-
-                    Rectangle other_box =
-                    {
-                        other->position.x + other->collision.x,
-                        other->position.y + other->collision.y,
-                        other->collision.width,
-                        other->collision.height
-                    };
-
-                    _Bool collides = CheckCollisionRecs(entity_box, other_box);
-
-                    if(collides)
-                    {
-                        collided_with = other;
-
-                        Vector2 entity_center =
-                        {
-                            entity->position.x + entity->collision.width / 2.0f,
-                            entity->position.y + entity->collision.height / 2.0f
-                        };
-
-                        Vector2 other_center =
-                        {
-                            other->position.x + other->collision.width / 2.0f,
-                            other->position.y + other->collision.height / 2.0f
-                        };
-
-                        Vector2 other_verts[4] =
-                        {
-                            other->position,
-                            Vector2Add(other->position, (Vector2){other->collision.width, 0.0f}),
-                            Vector2Add(other->position, (Vector2){other->collision.width, other->collision.height}),
-                            Vector2Add(other->position, (Vector2){0.0f, other->collision.height})
-                        };
-
-                        Vector2 collision_point = {0.0f, 0.0f};
-                        Vector2 tangel = {0.0f, 0.0f};
-
-                        if(CheckCollisionLines(entity_center, other_center, other_verts[0], other_verts[1], &collision_point))
-                        {
-                            tangel = (Vector2){1.0f, 0.0f};
-                        }
-
-                        if(CheckCollisionLines(entity_center, other_center, other_verts[1], other_verts[2], &collision_point))
-                        {
-                            tangel = (Vector2){0.0f, 1.0f};
-                        }
-
-                        if(CheckCollisionLines(entity_center, other_center, other_verts[2], other_verts[3], &collision_point))
-                        {
-                            tangel = (Vector2){1.0f, 0.0f};
-                        }
-
-                        if(CheckCollisionLines(entity_center, other_center, other_verts[3], other_verts[0], &collision_point))
-                        {
-                            tangel = (Vector2){0.0f, 1.0f};
-                        }
-
-                        entity->velocity = Vector2Scale(tangel, Vector2DotProduct(entity->velocity, tangel));
-                    }
-                }
-            }
+            U64 tick_time_us = current_time - Cast(U64, time_accumulator * 1000000.0f);
+            render_snapshot_fill(render_snapshot_begin(sim->snapshots), game, tick, tick_time_us);
+            render_snapshot_publish(sim->snapshots);
+        }
 
-            entity->position = Vector2Add(entity->position, Vector2Scale(entity->velocity, dt));
+        //- angn: sleep until the next tick is due
+        F32 time_to_next_tick = dt_fixed - time_accumulator;
+        if(time_to_next_tick > 0.001f)
+        {
+            os_sleep_milliseconds(Cast(U32, time_to_next_tick * 1000.0f));
         }
     }
 }
@@ -804,8 +3331,6 @@ main(
         int argc,
         char **argv)
 {
-    NotUsed(argc);
-
     //- angn: os
     {
         int os_error_code = os_init();
@@ -813,6 +3338,88 @@ main(
     }
     Arena *global_arena = os_get_arena();
 
+    //- angn: command line
+    B32 build_pak = 0;
+    char *replay_path = 0;
+    char *record_path = 0;
+    char *load_path = 0;   // angn: start from a saved snapshot instead of a fresh game
+    char *hashes_path = 0; // angn: write a state hash per played tick
+    char *compare_paths[2] = {0};
+    B32 bench = 0;
+    B32 sweep_cases = 0;
+    B32 math_tests = 0;
+    U64 workers = 0; // angn: game job workers, 0 picks from the core count, 1 runs every system in list order
+    for(int ai = 1;
+            ai < argc;
+            ai += 1)
+    {
+        B32 has_value = ai + 1 < argc;
+        if(strcmp(argv[ai], "--pak") == 0) { build_pak = 1; }
+        else if(strcmp(argv[ai], "--bench") == 0) { bench = 1; }
+        else if(strcmp(argv[ai], "--sweep-cases") == 0) { sweep_cases = 1; }
+        else if(strcmp(argv[ai], "--math-tests") == 0) { math_tests = 1; }
+        else if(has_value && strcmp(argv[ai], "--replay") == 0) { ai += 1; replay_path = argv[ai]; }
+        else if(has_value && strcmp(argv[ai], "--record") == 0) { ai += 1; record_path = argv[ai]; }
+        else if(has_value && strcmp(argv[ai], "--load") == 0) { ai += 1; load_path = argv[ai]; }
+        else if(has_value && strcmp(argv[ai], "--hashes") == 0) { ai += 1; hashes_path = argv[ai]; }
+        else if(has_value && strcmp(argv[ai], "--workers") == 0) { ai += 1; workers = strtoull(argv[ai], 0, 10); }
+        else if(ai + 2 < argc && strcmp(argv[ai], "--compare-hashes") == 0)
+        {
+            compare_paths[0] = argv[ai + 1];
+            compare_paths[1] = argv[ai + 2];
+            ai += 2;
+        }
+        else
+        {
+            fprintf(stderr, "WARNING: unknown argument %s\n", argv[ai]);
+        }
+    }
+
+    StateHashStream *hashes = 0;
+    if(hashes_path)
+    {
+        hashes = arena_push_array(global_arena, StateHashStream, 1);
+        if(!state_hash_stream_open(hashes, string8_from_cstring(hashes_path)))
+        {
+            fprintf(stderr, "WARNING: HASH: could not write to %s\n", hashes_path);
+            hashes = 0;
+        }
+    }
+
+    //- angn: build step, pack every asset into the pak and quit
+    if(build_pak)
+    {
+        return(pak_build(PAK_PATH) ? 0 : 1);
+    }
+
+    //- angn: tools that run headless and quit
+    if(bench)
+    {
+        int motion_result = bench_motion(global_arena);
+        int collisions_result = bench_collisions(global_arena);
+        int hash_map_result = bench_hash_map(global_arena);
+        return(motion_result || collisions_result || hash_map_result);
+    }
+    if(sweep_cases)
+    {
+        return(sweep_cases_run());
+    }
+    if(math_tests)
+    {
+        return(math_tests_run(global_arena));
+    }
+    if(compare_paths[0])
+    {
+        return(state_hash_compare(global_arena, string8_from_cstring(compare_paths[0]), string8_from_cstring(compare_paths[1])));
+    }
+    if(replay_path)
+    {
+        int result = replay_run(global_arena, string8_from_cstring(replay_path), hashes,
+                workers ? workers : os_get_system_info()->logical_processor_count);
+        if(hashes) { state_hash_stream_close(hashes); }
+        return(result);
+    }
+
     //- angn: init raylib
     SetConfigFlags(FLAG_WINDOW_UNDECORATED);
     InitWindow(0, 0, argv[0]);
@@ -821,6 +3428,7 @@ main(
     Game *game = arena_push_array(global_arena, Game, 1);
     game->screen.x = GetScreenWidth();
     game->screen.y = GetScreenHeight();
+    game->seed = os_now_microseconds();
 
     //- daria: init audio
     InitAudioDevice();
@@ -831,39 +3439,16 @@ main(
         exit(-1);
     }
 
-    for(U64 i = 0;
-            i < SoundName__Count;
-            i += 1)
-    {
-        game->sound_effects[i] = LoadSound(sound_names[i]);
-    }
-
-    //- daria: animations
-    // daria: TODO: have separate spritesheets or a single one
-    Texture2D player_texture = LoadTexture("textures/Creature.png");
-    Animation player_animation_down = animation_load(global_arena, player_texture, 1, 32);
-    player_animation_down.frames[0] = (AnimationFrame){ .sprite_map_index = 0, .duration = 1 };
+    AudioVoicePool *audio = arena_push_array(global_arena, AudioVoicePool, 1);
 
-    Animation player_animation_up = animation_load(global_arena, player_texture, 1, 32);
-    player_animation_up.frames[0] = (AnimationFrame){ .sprite_map_index = 1, .duration = 1 };
-
-    Animation player_animation_left = animation_load(global_arena, player_texture, 1, 32);
-    player_animation_left.frames[0] = (AnimationFrame){ .sprite_map_index = 2, .duration = 1 };
-
-    Animation player_animation_right = animation_load(global_arena, player_texture, 1, 32);
-    player_animation_right.frames[0] = (AnimationFrame){ .sprite_map_index = 3, .duration = 1 };
-
-    Animation player_animation_idle = animation_load(global_arena, player_texture, 4, 32);
-    player_animation_idle.frames[0] = (AnimationFrame){ .sprite_map_index = 0, .duration = 1 };
-    player_animation_idle.frames[1] = (AnimationFrame){ .sprite_map_index = 1, .duration = 1 };
-    player_animation_idle.frames[2] = (AnimationFrame){ .sprite_map_index = 2, .duration = 1 };
-    player_animation_idle.frames[3] = (AnimationFrame){ .sprite_map_index = 3, .duration = 1 };
+    //- angn: assets, streamed in while the menu is up
+    AssetSystem *assets = arena_push_array(global_arena, AssetSystem, 1);
+    asset_system_init(assets, global_arena);
 
     //- angn: fixed timestep
-    // angn: NOTE: is this update rate too high?
+    // angn: NOTE: rendering interpolates between the last two ticks, so the
+    // update rate does not need to match the refresh rate to look smooth
     F32 dt_fixed = 1.0f / 60.0f; // update rate
-    F32 time_accumulator = 0.0f; // carry any extra-time(under-updates) past the frame
-    F32 current_time = GetTime();
 
     //- angn: inputs
     KeyMap key_map = {0};
@@ -876,97 +3461,178 @@ main(
     key_map[InputTypes_Select_Spell_2] = KEY_L;
     key_map[InputTypes_Shoot] = KEY_I;
 
-    //- angn: entities
+    //- angn: game code, and the starting state it sets up
+    GameCode *code = arena_push_array(global_arena, GameCode, 1);
+    Arena *sim_scratch = arena_make();
+    if(!game_code_load(code, sim_scratch))
     {
-        Entity *player = alloc_entity(game);
-        Assert(player);
-        entity_flags_set(&player->flags, EntityFlagsIndex_WASDMotion);
-        entity_flags_set(&player->flags, EntityFlagsIndex_ApplyVelocity);
-        entity_flags_set(&player->flags, EntityFlagsIndex_ApplyFriction);
-        entity_flags_set(&player->flags, EntityFlagsIndex_Player);
-        entity_flags_set(&player->flags, EntityFlagsIndex_RenderTexture);
-        entity_flags_set(&player->flags, EntityFlagsIndex_ShootOnClick);
-        entity_flags_set(&player->flags, EntityFlagsIndex_Collider);
-
-        player->position = (Vector2){ Cast(F32, game->screen.x) * 0.5f, Cast(F32, game->screen.y) * 0.5f };
-        player->friction = 15.0f;
-
-        for(U64 i = 0;
-                i < SoundName__Count && i < SOUND_EFFECT_CAPACITY;
-                i++)
+        Assert(0 && "failed to load the game");
+        fprintf(stderr, "could not load %s\n", GAME_LIBRARY_PATH);
+        exit(-1);
+    }
+    code->api.init(game, global_arena);
+    String8 loaded_path = {0}; // angn: what the session started from, for the recording
+    if(load_path)
+    {
+        if(game_snapshot_load(global_arena, sim_scratch, game, string8_from_cstring(load_path)))
         {
-            player->sound_effects[i] = LoadSoundAlias(game->sound_effects[i]);
+            loaded_path = string8_from_cstring(load_path);
+        }
+        else
+        {
+            fprintf(stderr, "WARNING: SNAPSHOT: could not load %s, starting fresh\n", load_path);
         }
-        player->player_state = PlayerState_Up;
-
-        player->animations[PlayerState_Down] = player_animation_down;
-        player->animations[PlayerState_Up] = player_animation_up;
-        player->animations[PlayerState_Left] = player_animation_left;
-        player->animations[PlayerState_Right] = player_animation_right;
-        player->animations[PlayerState_Idle] = player_animation_idle;
     }
 
     F32 button_hot = 0;
     F32 button_active = 0;
     F32 button_rate = 0.001;
 
+    //- angn: simulation
+    // angn: NOTE: from here on the simulation thread owns `game`, the main
+    // thread only talks to it through the input queue and render snapshots
+    Simulation *sim = arena_push_array(global_arena, Simulation, 1);
+    sim->game = game;
+    sim->code = code;
+    sim->pool = job_pool_make(global_arena, workers ? workers : os_get_system_info()->logical_processor_count - 1); // angn: the main thread keeps its core
+    sim->scratch = sim_scratch;
+    sim->persist = arena_make();
+    sim->hashes = hashes;
+    sim->snapshot_ring.slots = arena_push_array(global_arena, Game, GAME_SNAPSHOT_RING_COUNT);
+    if(record_path)
+    {
+        sim->recorder = arena_push_array(global_arena, ReplayRecorder, 1);
+        if(!replay_recorder_open(sim->recorder, string8_from_cstring(record_path), game, dt_fixed, loaded_path))
+        {
+            fprintf(stderr, "WARNING: REPLAY: could not record to %s\n", record_path);
+            sim->recorder = 0;
+        }
+    }
+    sim->dt_fixed = dt_fixed;
+    sim->screen = U64FromTwoU32s(game->screen.x, game->screen.y);
+    sim->snapshots = arena_push_array(global_arena, RenderSnapshotBuffer, 1);
+    render_snapshot_buffer_init(sim->snapshots);
+    OS_Handle sim_thread = os_thread_launch(simulation_thread_entry, sim);
+
+    //- angn: per-frame scratch memory
+    Arena *frame_arena = arena_make();
+    TextCache *text_cache = arena_push_array(global_arena, TextCache, 1);
+
     //- angn: game loop
     B32 quit = 0;
-    Inputs frame_input = {0};
+    Inputs sent_input = {0}; // angn: the level the simulation was last told about
+    U8 unsent_presses[InputTypes__Count] = {0}; // angn: presses a full input queue turned away, retried every frame
+    U64 input_poll_time_us = os_now_microseconds();
+    U64 input_prev_poll_time_us = input_poll_time_us;
+    Vec2S32 screen = game->screen;
     GameState game_state = GameState_MainMenu; // acadia: TODO: save in Game
     for(;!quit;) // angn: TODO: remove that
     {
+        arena_clear(frame_arena);
+
         BeginDrawing();
         ClearBackground(RAYWHITE);
 
         //- angn: get information
-        game->screen.x = GetScreenWidth();
-        game->screen.y = GetScreenHeight();
-
-        //- angn: fixed time
-        F32 new_time = GetTime();
-        F32 frame_time = new_time - current_time;
-        current_time = new_time;
-
-        frame_time = Min(0.25f, frame_time); // angn: restrict number of updates
-                                             // so we don't do an update death spiral
-        time_accumulator += frame_time;
+        screen.x = GetScreenWidth();
+        screen.y = GetScreenHeight();
+        AtomicStoreU64(&sim->screen, U64FromTwoU32s(screen.x, screen.y));
 
         //- angn: get inputs
         if(IsKeyPressed(KEY_ESCAPE)) { quit = 1; } // angn: TODO: remove this
 
+#if BUILD_DEBUG
+        //- angn: snapshots
+        if(IsKeyPressed(KEY_F5)) { AtomicStoreU64(&sim->request, SimulationRequest_Save); }
+        if(IsKeyPressed(KEY_F9)) { AtomicStoreU64(&sim->request, SimulationRequest_Load); }
+        if(IsKeyPressed(KEY_F6)) { AtomicStoreU64(&sim->request, SimulationRequest_Rewind); }
+#endif
+
+        // angn: raylib queues every press since the last poll, IsKeyPressed
+        // only tells us there was at least one
+        U8 presses[InputTypes__Count] = {0};
+        for(KeyboardKey pressed = GetKeyPressed();
+                pressed != KEY_NULL;
+                pressed = GetKeyPressed())
+        {
+            for(InputTypes ki = 0;
+                    ki < StaticArrayLength(key_map);
+                    ki += 1)
+            {
+                if(key_map[ki] == pressed) { presses[ki] += 1; }
+            }
+        }
+
+        // angn: only send edges, the simulation keeps the last known level
+        // angn: NOTE: all we know is that it happened between the last two polls,
+        // so repeated presses are spread over that window instead of stacking up
+        // angn: NOTE: sent_input only moves once the queue took the event, so
+        // whatever a full queue (simulation stalled on a load or a reload) turns
+        // away is sent again next frame, presses first, then the level
+        U64 input_poll_span_us = input_poll_time_us - input_prev_poll_time_us;
         for(InputTypes ki = 0;
                 ki < StaticArrayLength(key_map);
                 ki += 1)
         {
             KeyboardKey key = key_map[ki];
-            frame_input[ki] &= ~(InputState_Up | InputState_Down); // angn: reset input state for non-event actions
-            if(IsKeyDown(key)) { frame_input[ki] |= InputState_Down; }
-            if(IsKeyUp(key)) { frame_input[ki] |= InputState_Up; }
-            if(IsKeyPressed(key)) { frame_input[ki] |= InputState_Pressed; }
-            if(IsKeyReleased(key)) { frame_input[ki] |= InputState_Released; }
-        }
-
+            U64 presses_count = presses[ki];
+            if(presses_count == 0 && IsKeyPressed(key)) { presses_count = 1; }
+            unsent_presses[ki] = Cast(U8, Min(unsent_presses[ki] + presses_count, 255));
+
+            U64 pending_count = unsent_presses[ki];
+            for(U64 pi = 0;
+                    pi < pending_count;
+                    pi += 1)
+            {
+                U64 time_us = input_prev_poll_time_us + input_poll_span_us * (pi + 1) / pending_count;
+                if(sent_input[ki] == InputState_Down) // angn: missed the release in between
+                {
+                    if(!input_queue_push(&sim->input_queue, (InputEvent){ time_us, ki, InputState_Up | InputState_Released }))
+                    {
+                        break;
+                    }
+                    sent_input[ki] = InputState_Up;
+                }
+                if(!input_queue_push(&sim->input_queue, (InputEvent){ time_us, ki, InputState_Down | InputState_Pressed }))
+                {
+                    break;
+                }
+                sent_input[ki] = InputState_Down;
+                unsent_presses[ki] -= 1;
+            }
 
-        //- angn: update
-        for(;
-                time_accumulator > dt_fixed;
-                time_accumulator -= dt_fixed)
-        {
-            if(game_state != GameState_MainMenu)
+            InputState level = IsKeyDown(key) ? InputState_Down : InputState_Up;
+            if(unsent_presses[ki] == 0 && level != sent_input[ki])
             {
-                game_update(game, frame_input, dt_fixed);
+                InputState edge = (level == InputState_Up && sent_input[ki] == InputState_Down) ? InputState_Released : 0;
+                if(input_queue_push(&sim->input_queue, (InputEvent){ input_poll_time_us, ki, level | edge }))
+                {
+                    sent_input[ki] = level;
+                }
             }
+        }
 
-            //- angn: unset the pressed and released flags
-            // angn: NOTE: ideally we would obtain new inputs, be we seem to be
-            // having issues getting the Pressed event when calling PollInputEvents
-            for(InputTypes ki = 0;
-                    ki < InputTypes__Count;
-                    ki += 1)
+        //- angn: finish any assets the workers have decoded
+        asset_system_upload(assets, audio, ASSET_UPLOAD_BUDGET_US);
+        U64 assets_ready = asset_system_ready_count(assets);
+
+        RenderSnapshot *snapshot = render_snapshot_acquire(sim->snapshots);
+
+        //- angn: audio
+        // angn: the player is the listener, the screen center until it exists
+        {
+            Vector2 listener = { Cast(F32, screen.x) * 0.5f, Cast(F32, screen.y) * 0.5f };
+            for(U64 ri = 0;
+                    ri < snapshot->entities_count;
+                    ri += 1)
             {
-                frame_input[ki] &= ~(InputState_Pressed | InputState_Released);
+                if(entity_flags_contains(&snapshot->entities[ri].flags, EntityFlagsIndex_Player))
+                {
+                    listener = snapshot->entities[ri].position;
+                    break;
+                }
             }
+            audio_flush(audio, &sim->sound_event_queue, listener);
         }
 
         switch(game_state)
@@ -974,19 +3640,24 @@ main(
         case GameState_MainMenu:
         {
             Font font = GetFontDefault();
-            U64 button_width = game->screen.x / 3;
+            U64 button_width = screen.x / 3;
             U64 button_height = 60;
             Rectangle button_rect = (Rectangle)
             {
-                (game->screen.x / 2) - (button_width / 2),
-                (game->screen.y / 2) - (button_height / 2),
+                (screen.x / 2) - (button_width / 2),
+                (screen.y / 2) - (button_height / 2),
                 button_width,
                 button_height
             };
             Color button_color = RED;
             Color button_text_color = WHITE;
-            char *button_text = "CLICK ME TO START";
-            int button_font_size = 40;
+            B32 loading = assets_ready < AssetId__Count;
+            String8 button_text = String8Lit("CLICK ME TO START");
+            if(loading)
+            {
+                button_text = string8_push_fmt(frame_arena, "LOADING %llu/%llu", Cast(unsigned long long, assets_ready), Cast(unsigned long long, AssetId__Count));
+            }
+            F32 button_font_size = 40;
             bool button_clicked = false;
             bool button_hovered = false;
 
@@ -996,11 +3667,12 @@ main(
             {
                 button_hovered = true;
                 button_hot += (1 - button_hot) * button_rate;
-                if(IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+                if(!loading && IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
                 {
                     button_clicked = true;
                     button_active = 1;
                     game_state = GameState_Playing;
+                    AtomicStoreU64(&sim->playing, 1);
                 }
             }
             else
@@ -1014,103 +3686,135 @@ main(
 
             // acadia: render button
             {
-                Vector2 text_pos = { game->screen.x / 2, game->screen.y / 2 };
+                Vector2 text_pos = { screen.x / 2, screen.y / 2 };
 
-                Vector2 text_size = MeasureTextEx(font, button_text, button_font_size, button_font_size * 0.1f);
+                Vector2 text_size = text_cache_measure(text_cache, font, button_text, button_font_size, button_font_size * 0.1f);
 
                 DrawRectangleRounded(button_rect, 0.5f, 0.0f, button_color);
-                DrawText(button_text,
-                        button_rect.x + (button_rect.width / 2) - (text_size.x / 2),
-                        button_rect.y + (button_rect.height / 2) - (text_size.y / 2),
+                text_cache_draw(text_cache, font, button_text,
+                        (Vector2)
+                        {
+                            floorf(button_rect.x + (button_rect.width / 2) - (text_size.x / 2)),
+                            floorf(button_rect.y + (button_rect.height / 2) - (text_size.y / 2)),
+                        },
                         button_font_size,
+                        button_font_size * 0.1f,
                         WHITE);
             }
 
             // acadia: render welcome text
             {
-                char *text = "Orthography";
-                Vector2 text_size = MeasureTextEx(font, text, 200, 200 * 0.1f);
-                DrawText(text, (game->screen.x / 2) - (text_size.x / 2), game->screen.y / 4, 200, ORANGE);
+                String8 text = String8Lit("Orthography");
+                Vector2 text_size = text_cache_measure(text_cache, font, text, 200, 200 * 0.1f);
+                text_cache_draw(text_cache, font, text,
+                        (Vector2){ floorf((screen.x / 2) - (text_size.x / 2)), Cast(F32, screen.y / 4) },
+                        200,
+                        200 * 0.1f,
+                        ORANGE);
             }
         } break;
 
         case GameState_Playing:
         {
+            //- angn: interpolate between the previous and current tick
+            // angn: NOTE: the time since the snapshot's tick is how far we are
+            // into the next tick, we render that far along the last one
+            S64 time_since_tick_us = Cast(S64, os_now_microseconds() - snapshot->tick_time_us);
+            F32 render_alpha = Clamp(Cast(F32, time_since_tick_us) / (dt_fixed * 1000000.0f), 0.0f, 1.0f);
+
+            //- angn: cull against the view
+            Rectangle view = render_view_from_screen(screen, RENDER_CULL_MARGIN);
+            RenderVisibleList visible = render_snapshot_query_visible(frame_arena, snapshot, view, render_alpha);
+
             //- angn: render game
-            for(U64 ei = 0;
-                    ei < ENTITIES_CAPACITY;
-                    ei += 1)
+            for(U64 vi = 0;
+                    vi < visible.count;
+                    vi += 1)
             {
-                Entity *entity = &game->entities[ei];
-                if(!entity_flags_contains(&entity->flags, EntityFlagsIndex_Alive))
-                {
-                    continue;
-                }
+                RenderEntity *entity = &snapshot->entities[visible.indices[vi]];
+
+                Vector2 render_position = Vector2Lerp(entity->prev_position, entity->position, render_alpha);
+                F32 render_rotation = Lerp(entity->prev_rotation, entity->rotation, render_alpha);
 
                 //- daria: render entity
                 if(entity_flags_contains(&entity->flags, EntityFlagsIndex_RenderTexture))
                 {
-                    Animation *animation = &entity->animations[entity->player_state];
-                    AnimationFrame *frame = &animation->frames[animation->current_frame];
+                    Texture2D *texture = asset_texture(assets, entity->texture);
+                    if(texture == 0)
+                    {
+                        continue;
+                    }
 
                     // daria: TODO: precompute?
-                    U32 row_size = animation->texture.width / animation->cell_size;
+                    U32 row_size = texture->width / entity->cell_size;
 
                     Rectangle frame_rec =
                     {
-                        .x = Cast(F32, (frame->sprite_map_index % row_size) * animation->cell_size),
-                        .y = Cast(F32, (frame->sprite_map_index / row_size) * animation->cell_size),
-                        .width = animation->cell_size,
-                        .height = animation->cell_size,
+                        .x = Cast(F32, (entity->sprite_map_index % row_size) * entity->cell_size),
+                        .y = Cast(F32, (entity->sprite_map_index / row_size) * entity->cell_size),
+                        .width = entity->cell_size,
+                        .height = entity->cell_size,
                     };
 
                     Rectangle dest_rec =
                     {
-                        .x = entity->position.x,
-                        .y = entity->position.y,
-                        .width = 128,
-                        .height = 128
+                        .x = render_position.x,
+                        .y = render_position.y,
+                        .width = RENDER_SPRITE_SIZE,
+                        .height = RENDER_SPRITE_SIZE
                     };
 
                     Vector2 origin = (Vector2)
                     {
-                        .x = animation->cell_size,
-                        .y = animation->cell_size
+                        .x = entity->cell_size,
+                        .y = entity->cell_size
                     };
 
                     DrawTexturePro(
-                            entity->animations[entity->player_state].texture,
+                            *texture,
                             frame_rec,
                             dest_rec,
                             origin,
                             0,
                             WHITE);
-
-                    animation_next_frame(animation);
                 }
                 else
                 {
-                    DrawCircleV(entity->position, 25.0f, SKYBLUE);
-                    DrawLineV(entity->position, Vector2Add(entity->position, Vector2Rotate((Vector2){10.0f, 0.0f}, entity->spell_data.rotation)), RED);
+                    DrawCircleV(render_position, RENDER_SPELL_RADIUS, SKYBLUE);
+                    DrawLineV(render_position, Vector2Add(render_position, Vector2Rotate((Vector2){10.0f, 0.0f}, render_rotation)), RED);
                 }
             }
+
+#if BUILD_DEBUG
+            String8 draw_stats = string8_push_fmt(frame_arena, "drawn: %llu culled: %llu", Cast(unsigned long long, visible.count), Cast(unsigned long long, visible.culled_count));
+            DrawText((char *)draw_stats.string, 10, 10, 20, DARKGRAY);
+#endif
         } break;
         }
 
         EndDrawing();
+
+        // angn: EndDrawing polls for input, everything it found happened before now
+        input_prev_poll_time_us = input_poll_time_us;
+        input_poll_time_us = os_now_microseconds();
     }
 
+    //- angn: stop the simulation before tearing down what it uses
+    AtomicStoreU64(&sim->quit, 1);
+    os_thread_join(sim_thread);
+    job_pool_release(sim->pool);
+    if(sim->recorder) { replay_recorder_close(sim->recorder); }
+    if(sim->hashes) { state_hash_stream_close(sim->hashes); }
+    game_code_release(code);
+
     //- daria: audio cleanup
-    for(U64 i = 0;
-            i < SoundName__Count;
-            i += 1)
-    {
-        UnloadSound(game->sound_effects[i]);
-    }
+    asset_system_release(assets);
+    audio_voice_pool_release(audio);
 
     CloseAudioDevice();
 
     //- angn: cleanup
+    text_cache_release(text_cache);
     CloseWindow();
     return(0);
 }
@@ -4,6 +4,9 @@
 #define IMPL_POUNDC_STRING 1
 #define IMPL_POUNDC_OS 1
 #define IMPL_POUNDC_ARENA 1
+#define IMPL_POUNDC_RANDOM 1
+#define IMPL_POUNDC_MATH 1
+#define IMPL_POUNDC_HASH 1
 #include "pound.c"
 #undef Lerp
 #undef Clamp
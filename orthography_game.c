@@ -0,0 +1,1259 @@
+#include "orthography_game.h"
+
+// angn: NOTE: with BUILD_HOT_RELOAD this file is its own shared library, and
+// gets a private copy of every pound.c global, so game code must only touch
+// memory it is handed (no arena_make, os_get_arena or other os_* state). the
+// one exception is the system info, game_load copies the host's in so arenas
+// it is handed can still chain new blocks
+
+internal Entity *
+get_entity_from_handle(
+        Game *game,
+        Handle handle)
+{
+    Assert(handle.index < ENTITIES_CAPACITY);
+    Entity *entity = &game->entities[handle.index];
+    if(entity->handle.gen != handle.gen) { entity = 0; }
+    return(entity);
+}
+
+internal Entity *
+alloc_entity(
+        Game *game)
+    // angn: SUGGEST: should we allow for bulk allocations?
+{
+    Entity *entity = 0;
+
+    if(game->entities_count + 1 >= ENTITIES_CAPACITY)
+    {
+        Assert(0 && "out of memory");
+        fprintf(stderr, "you won i guess??\n");
+        exit(-1);
+    }
+    else
+    {
+        EntityQuery query = entity_query_make(game, 0, EntityFlagsMask(EntityFlagsIndex_Alive));
+        if(entity_query_next(&query))
+        {
+            entity = game->entities + query.index;
+            entity->handle.index = query.index;
+            entity->handle.gen += 1;
+            game->entities_count += 1;
+        }
+    }
+
+    if(entity)
+    {
+        Handle temp_handle = entity->handle;
+        memset(entity, 0, sizeof(Entity));
+        entity->handle = temp_handle;
+        entity_flags_set_in(game, entity, EntityFlagsIndex_Alive);
+    }
+
+    return(entity);
+}
+
+internal void
+destroy_entity(
+        Game *game,
+        Handle handle)
+{
+    Assert(handle.index < ENTITIES_CAPACITY);
+    Entity *entity = game->entities + handle.index;
+    if(entity_flags_contains(&entity->flags, EntityFlagsIndex_Alive))
+    {
+        entity_flags_unset_in(game, entity, EntityFlagsIndex_Alive);
+        game->entities_count -= 1;
+    }
+}
+
+internal void
+sound_event_push(
+        Game *game,
+        EventType event,
+        SoundName name,
+        Vector2 position)
+{
+    if(game->sound_events_count < SOUND_EVENTS_MAX)
+    {
+        game->sound_events[game->sound_events_count] = (SoundEvent)
+        {
+            .event = event,
+            .name = name,
+            .position = position,
+        };
+        game->sound_events_count += 1;
+    }
+}
+
+internal void
+collision_event_push(
+        GameSystemContext *context,
+        CollisionEvent event)
+{
+    if(context->collision_events_count < COLLISIONS_MAX)
+    {
+        context->collision_events[context->collision_events_count] = event;
+        context->collision_events_count += 1;
+    }
+    else
+    {
+        context->collision_events_dropped += 1;
+    }
+}
+
+// angn: NOTE: runs on any worker, only reads the tick's boxes and writes its own results
+internal void
+collision_sweep_job(
+        void *params,
+        U64 job_index,
+        U64 worker_index)
+{
+    CollisionSweepJob *job = (CollisionSweepJob *)params;
+    Game *game = job->game;
+    EntityMotion *motion = &game->motion;
+    U64 boxes_count = job->grid->boxes_count;
+
+    TempArena temp = temp_arena_begin(job->jobs->scratch[worker_index]);
+    U8 *seen = arena_push_array(temp.arena, U8, boxes_count);
+    U32 *candidates = arena_push_array_no_zero(temp.arena, U32, boxes_count);
+    Rectangle *candidate_boxes = arena_push_array_no_zero(temp.arena, Rectangle, boxes_count);
+
+    U64 movers_end = Min(job->movers_count, (job_index + 1) * COLLISION_JOB_MOVERS);
+    for(U64 mi = job_index * COLLISION_JOB_MOVERS;
+            mi < movers_end;
+            mi += 1)
+    {
+        U64 ci = job->movers[mi];
+        Entity *entity = &game->entities[motion->collider_entities[ci]];
+        Rectangle box = motion->collider_boxes[ci];
+
+        //- angn: everything the box can reach this step, a bounce can come back the full step
+        Vector2 reach = { fabsf(entity->velocity.x * job->dt), fabsf(entity->velocity.y * job->dt) };
+        Rectangle region = { box.x - reach.x, box.y - reach.y, box.width + 2.0f * reach.x, box.height + 2.0f * reach.y };
+        U64 candidates_count = collision_grid_query(job->grid, region, ci, seen, candidates);
+        for(U64 i = 0;
+                i < candidates_count;
+                i += 1)
+        {
+            candidate_boxes[i] = motion->collider_boxes[candidates[i]];
+        }
+
+        SweepResult sweep = sweep_move(box, entity->velocity, job->dt,
+                candidate_boxes, candidates_count, candidates_count,
+                entity_flags_contains(&entity->flags, EntityFlagsIndex_ApplyBounce));
+        for(U64 hi = 0;
+                hi < sweep.contacts_count;
+                hi += 1)
+        {
+            sweep.contacts[hi].obstacle = candidates[sweep.contacts[hi].obstacle];
+        }
+        job->results[mi] = sweep;
+    }
+    temp_arena_end(temp);
+}
+
+// angn: NOTE: runs on any worker, like collision_sweep_job
+internal void
+collision_trigger_job(
+        void *params,
+        U64 job_index,
+        U64 worker_index)
+{
+    CollisionTriggerJob *job = (CollisionTriggerJob *)params;
+    Game *game = job->game;
+    EntityMotion *motion = &game->motion;
+    Arena *arena = job->jobs->scratch[worker_index];
+    U8 *seen = job->seen[worker_index];
+    U32 *candidates = job->candidates[worker_index];
+
+    U64 triggers_end = Min(job->triggers_count, (job_index + 1) * COLLISION_JOB_MOVERS);
+    for(U64 ti = job_index * COLLISION_JOB_MOVERS;
+            ti < triggers_end;
+            ti += 1)
+    {
+        U64 trigger_index = job->triggers[ti];
+        Entity *trigger = &game->entities[trigger_index];
+        Rectangle trigger_box =
+        {
+            trigger->position.x + trigger->collision.x,
+            trigger->position.y + trigger->collision.y,
+            trigger->collision.width,
+            trigger->collision.height
+        };
+        Vector2 trigger_delta = { motion->position_x[trigger_index] - trigger->position.x, motion->position_y[trigger_index] - trigger->position.y };
+
+        //- angn: only colliders whose swept box met the trigger's swept box can have touched it
+        Rectangle region =
+        {
+            trigger_box.x + Min(trigger_delta.x, 0.0f),
+            trigger_box.y + Min(trigger_delta.y, 0.0f),
+            trigger_box.width + fabsf(trigger_delta.x),
+            trigger_box.height + fabsf(trigger_delta.y),
+        };
+        U64 candidates_count = collision_grid_query(job->grid, region, job->grid->boxes_count, seen, candidates);
+
+        CollisionTriggerResult *result = &job->results[ti];
+        result->events = arena_push_array_no_zero(arena, CollisionEvent, candidates_count);
+        result->events_count = 0;
+        for(U64 i = 0;
+                i < candidates_count;
+                i += 1)
+        {
+            U64 ci = candidates[i];
+            U64 other_index = motion->collider_entities[ci];
+            if(other_index == trigger_index)
+            {
+                continue;
+            }
+
+            Entity *other = &game->entities[other_index];
+            Vector2 other_delta = { motion->position_x[other_index] - other->position.x, motion->position_y[other_index] - other->position.y };
+            SweepHit hit = {0};
+            if(CheckCollisionRecs(motion->collider_boxes[ci], trigger_box))
+            {
+                hit.hit = 1;
+            }
+            else
+            {
+                hit = sweep_aabb(motion->collider_boxes[ci], Vector2Subtract(other_delta, trigger_delta), trigger_box);
+            }
+
+            if(hit.hit)
+            {
+                result->events[result->events_count] = (CollisionEvent)
+                {
+                    .kind = CollisionEventKind_Trigger,
+                    .a = trigger->handle,
+                    .b = other->handle,
+                    .normal = hit.normal,
+                    .time = hit.time,
+                };
+                result->events_count += 1;
+            }
+        }
+        arena_pop_array(arena, CollisionEvent, candidates_count - result->events_count);
+    }
+}
+
+internal void
+game_system_spell_edit(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    InputState *inputs = context->inputs;
+    (void)first;
+    (void)end;
+
+    //- nick: spell editing
+    S8 spell_select = -1;
+    if(inputs[InputTypes_Select_Spell_0] & InputState_Pressed) { spell_select = 0; }
+    else if(inputs[InputTypes_Select_Spell_1] & InputState_Pressed) { spell_select = 1; }
+    else if(inputs[InputTypes_Select_Spell_2] & InputState_Pressed) { spell_select = 2; }
+
+    if(spell_select >= 0)
+    {
+        SpellData *sc = &game->spell_construction;
+
+        if(game->new_spell)
+        {
+            sc->type = game->spell_type_rand[spell_select];
+            printf("spell type: %d\n", sc->type);
+            game->new_spell = 0;
+
+            for(
+                    U8 i = 0;
+                    i < 3;
+                    i++)
+            {
+                game->spell_type_rand[i] = random_u32_bounded(&game->random, SpellType__Count);
+            }
+        }
+        else
+        {
+            if(sc->program_length < SPELL_SLOTS_MAX)
+            {
+                game->spell_programs[sc->program_index][sc->program_length] =
+                    game->spell_instruction_rand[spell_select];
+
+                printf("spell instruction: %d\n", game->spell_programs[sc->program_index][sc->program_length]);
+
+                for(
+                    U8 i = 0;
+                    i < 3;
+                    i++)
+                {
+                    // TODO: the rest
+                    game->spell_instruction_rand[i] = random_u32_bounded(&game->random, 7);
+                }
+            }
+            else
+            {
+                // idk kill them irl or smth
+            }
+        }
+
+        sc->program_length++;
+    }
+}
+
+internal void
+game_system_friction(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    F32 dt = context->dt;
+    EntityMotion *motion = &game->motion;
+
+    //- angn: friction, packed
+    // angn: NOTE: friction always worked off the velocity the tick started
+    // with, so everyone can have it applied up front
+    memset(motion->scale + first, 0, sizeof(motion->scale[0]) * (end - first));
+    for(U64 ei = first;
+            ei < end;
+            ei += 1)
+    {
+        motion->velocity_x[ei] = game->entities[ei].velocity.x;
+        motion->velocity_y[ei] = game->entities[ei].velocity.y;
+    }
+    for(EntityQuery query = entity_query_make_range(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_ApplyFriction), EntityFlagsMask(EntityFlagsIndex_Sleeping), first, end);
+            entity_query_next(&query);)
+    {
+        motion->scale[query.index] = game->entities[query.index].friction * dt;
+    }
+    motion_apply_friction(motion->velocity_x + first, motion->velocity_y + first, motion->scale + first, end - first);
+    for(U64 ei = first;
+            ei < end;
+            ei += 1)
+    {
+        game->entities[ei].velocity = (Vector2){ motion->velocity_x[ei], motion->velocity_y[ei] };
+    }
+}
+
+internal void
+game_system_animation(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    (void)context;
+
+    //- angn: previous transforms and animation
+    for(EntityQuery query = entity_query_make_range(game, EntityFlagsMask(EntityFlagsIndex_Alive), 0, first, end);
+            entity_query_next(&query);)
+    {
+        Entity *entity = &game->entities[query.index];
+
+        //- angn: keep the previous transform, the renderer blends between the two
+        entity->prev_position = entity->position;
+        entity->spell_data.prev_rotation = entity->spell_data.rotation;
+
+        // angn: should we feature flag this?
+        entity->animations[entity->player_state].frame_duration++;
+        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_RenderTexture))
+        {
+            animation_next_frame(&entity->animations[entity->player_state]);
+        }
+    }
+}
+
+internal void
+game_system_input(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    InputState *inputs = context->inputs;
+    F32 dt = context->dt;
+
+    //- daria: wasd
+    for(EntityQuery query = entity_query_make_range(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_WASDMotion), 0, first, end);
+            entity_query_next(&query);)
+    {
+        Entity *entity = &game->entities[query.index];
+
+        Vector2 dir = {0};
+
+        PlayerState old_state = entity->player_state;
+
+        // daria: NOTE: this assumes it's a player
+        // daria: TODO: determine entity type
+        if(inputs[InputTypes_W] & InputState_Down)
+        {
+            dir.y -= 1.0f;
+            entity->player_state = PlayerState_Up;
+        }
+        if(inputs[InputTypes_S] & InputState_Down)
+        {
+            dir.y += 1.0f;
+            entity->player_state = PlayerState_Down;
+        }
+        if(inputs[InputTypes_D] & InputState_Down)
+        {
+            dir.x += 1.0f;
+            entity->player_state = PlayerState_Right;
+        }
+        if(inputs[InputTypes_A] & InputState_Down)
+        {
+            dir.x -= 1.0f;
+            entity->player_state = PlayerState_Left;
+        }
+
+        if(dir.x == 0.0f && dir.y == 0.0f)
+        {
+            entity->player_state = PlayerState_Idle;
+        }
+
+        if(old_state != entity->player_state)
+        {
+            entity->animations[old_state].frame_duration = 0;
+        }
+
+        dir = Vector2ClampValue(dir, 0.0f, 1.0f);
+        if(dir.x != 0.0f || dir.y != 0.0f)
+        {
+            entity_wake(game, entity);
+        }
+
+        if(entity_flags_contains(&entity->flags, EntityFlagsIndex_ApplyFriction))
+        {
+            entity->velocity =
+                Vector2Add(
+                        entity->velocity,
+                        Vector2Scale(dir, entity->friction * 1000.0f * dt));
+        }
+        else
+        {
+            entity->velocity =
+                Vector2Add(
+                        entity->velocity,
+                        Vector2Scale(dir, 1000.0f * dt));
+        }
+    }
+}
+
+internal void
+game_system_shoot(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    InputState *inputs = context->inputs;
+    (void)first;
+    (void)end;
+
+    //- angn: shooting
+    // angn: TODO: this is just an example
+    for(EntityQuery query = entity_query_make(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_ShootOnClick), 0);
+            entity_query_next(&query);)
+    {
+        Entity *entity = &game->entities[query.index];
+
+        if(inputs[InputTypes_Shoot] & InputState_Pressed) {
+            game->spell_construction.slot_index = 0;
+            game->new_spell = 1;
+
+            sound_event_push(game, EventType_Shoot, entity->sound_effects[EventType_Shoot], entity->position);
+
+            Entity *spell = alloc_entity(game);
+            Assert(spell);
+            spell->position = entity->position;
+            spell->prev_position = entity->prev_position;
+            spell->velocity = entity->velocity;
+            spell->friction = 1.0f;
+            spell->spell_data = game->spell_construction;
+            spell->spell_data.rotation = Vector2Angle((Vector2){1.0f, 0.0f}, spell->velocity);
+            spell->spell_data.prev_rotation = spell->spell_data.rotation;
+            spell->sound_effects[EventType_Explode] = entity->sound_effects[EventType_Explode];
+
+            switch(game->spell_construction.type)
+            {
+            default:
+                puts("hi :3");
+                break;
+
+            case SpellType_Bomb:
+            {
+                spell->spell_data.lifetime = spell->spell_data.program_length;
+                spell->spell_data.ticks_per_step = 30; // 0.5sec : step
+            } break;
+
+            case SpellType_Bolt:
+            {
+                spell->spell_data.lifetime = spell->spell_data.program_length * 2;
+                spell->spell_data.ticks_per_step = 15; // 0.25sec : step
+            } break;
+
+            case SpellType_Loop_Bolt:
+            {
+                spell->spell_data.lifetime = spell->spell_data.program_length * 5;
+                spell->spell_data.ticks_per_step = 15; // 0.3sec : step
+            } break;
+
+            case SpellType_Bounce_Bolt:
+            {
+                spell->spell_data.lifetime = spell->spell_data.program_length * 10;
+                spell->spell_data.ticks_per_step = 6; // 0.1sec : step
+            } break;
+            }
+
+            entity_flags_set_in(game, spell, EntityFlagsIndex_Spell);
+            entity_flags_set_in(game, spell, EntityFlagsIndex_Trigger);
+            entity_flags_set_in(game, spell, EntityFlagsIndex_ApplyVelocity);
+            entity_flags_set_in(game, spell, EntityFlagsIndex_ApplyFriction);
+            if(spell->spell_data.type == SpellType_Bounce_Bolt)
+            {
+                // angn: swept like any other body, so it comes off walls instead
+                // of passing through them. set after ApplyVelocity, it is never static
+                entity_flags_set_in(game, spell, EntityFlagsIndex_Collider);
+                entity_flags_set_in(game, spell, EntityFlagsIndex_ApplyBounce);
+            }
+
+            game->spell_construction = (SpellData){0};
+            game->spell_construction.program_index = (game->spell_construction.program_index + 1) % SPELL_PROGRAMS_MAX;
+        }
+    }
+}
+
+internal void
+game_system_spell_step(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    (void)context;
+    (void)first;
+    (void)end;
+
+    //- nick: spells
+    for(EntityQuery query = entity_query_make(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_Spell), 0);
+            entity_query_next(&query);)
+    {
+        Entity *entity = &game->entities[query.index];
+
+        if(entity->spell_data.tick >= entity->spell_data.ticks_per_step)
+        {
+            entity->spell_data.tick = 0;
+            entity->spell_data.lifetime--;
+
+            SpellInstruction next = game->spell_programs
+                    [entity->spell_data.program_index]
+                    [entity->spell_data.slot_index];
+
+            entity->spell_data.slot_index = (entity->spell_data.slot_index + 1) % entity->spell_data.program_length;
+            entity_wake(game, entity);
+
+            switch(next)
+            {
+            default: {} break;
+            case SpellInstruction_Accel_Forward:
+            {
+                entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){1.0f, 0.0f}, entity->spell_data.rotation), 100.0f));
+                puts("fwd");
+            } break;
+            case SpellInstruction_Accel_Left:
+            {
+                entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){0.0f, -1.0f}, entity->spell_data.rotation), 100.0f));
+                puts("left");
+            } break;
+            case SpellInstruction_Accel_Right:
+            {
+                entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){0.0f, -1.0f}, entity->spell_data.rotation), 100.0f));
+                puts("right");
+            } break;
+            case SpellInstruction_Accel_Back:
+            {
+                entity->velocity = Vector2Add(entity->velocity, Vector2Scale(Vector2Rotate((Vector2){-1.0f, 0.0f}, entity->spell_data.rotation), 100.0f));
+                puts("back");
+            } break;
+            case SpellInstruction_Turn_Left:
+            {
+                entity->spell_data.rotation += (30.0f / 180.0f) * PI;
+                puts("turn left");
+            } break;
+            case SpellInstruction_Turn_Right:
+            {
+                entity->spell_data.rotation -= (30.0f / 180.0f) * PI;
+                puts("turn right");
+            } break;
+            case SpellInstruction_Turn_About:
+            {
+                entity->spell_data.rotation += PI;
+                puts("turn about");
+            } break;
+            case SpellInstruction_Face_Enemy:
+            {
+            } break;
+            case SpellInstruction_Face_Player:
+            {
+                // for(
+                //         U64 i = 0;
+                //         i < ENTITIES_CAPACITY;
+                //         i++)
+                // {
+                //     if(entity_flags_contains(&entity->flags, EntityFlagsIndex_Player)) {
+                //     }
+                // }
+            } break;
+            case SpellInstruction_Abeam_Enemy:
+            {
+            } break;
+            case SpellInstruction_Abeam_Player:
+            {
+            } break;
+
+            //~ nick: utility spells
+            case SpellInstruction_Duplicate:
+            {
+            } break;
+            case SpellInstruction_Death_Duplicate:
+            {
+            } break;
+            case SpellInstruction_Burst_Duplicate:
+            {
+            } break;
+            case SpellInstruction_Increase_Lifetime:
+            {
+            } break;
+            case SpellInstruction_Decrease_Lifetime:
+            {
+            } break;
+            case SpellInstruction_Destroy_Spell:
+            {
+            } break;
+            case SpellInstruction_Increase_Execution_Speed:
+            {
+            } break;
+            case SpellInstruction_Decrease_Execution_Speed:
+            {
+            } break;
+            case SpellInstruction_Loop:
+            {
+            } break;
+
+            //~ nick: effect spells
+            case SpellInstruction_Arm_Pierce:
+            {
+                entity->spell_data.armed |= SpellArmed_Pierce;
+            } break;
+            case SpellInstruction_Arm_Explode:
+            {
+                entity->spell_data.armed |= SpellArmed_Explode;
+            } break;
+            case SpellInstruction_Do_Sear:
+            {
+                // angn: TODO: nothing has health to sear yet, once it does this
+                // reads this spell's Trigger events from the stream like spell hits
+            } break;
+            case SpellInstruction_Do_Flameburst:
+            {
+            } break;
+            }
+        }
+
+        if(entity->spell_data.lifetime <= 0) {
+            destroy_entity(game, entity->handle);
+            puts("die");
+        }
+
+        entity->spell_data.tick++;
+    }
+}
+
+internal void
+game_system_collide(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    F32 dt = context->dt;
+    GameJobs *jobs = context->jobs;
+    EntityMotion *motion = &game->motion;
+    (void)first;
+    (void)end;
+
+    //- nick: collisions
+    // angn: static boxes first, rebuilt only when a static collider came or went
+    U64 sleeping_mask = EntityFlagsMask(EntityFlagsIndex_Sleeping);
+    if(game->statics_dirty)
+    {
+        game->statics_dirty = 0;
+        game->statics_count = 0;
+        for(EntityQuery query = entity_query_make(game, ENTITY_STATIC_REQUIRED, ENTITY_STATIC_EXCLUDED);
+                entity_query_next(&query);)
+        {
+            Entity *entity = &game->entities[query.index];
+            motion->collider_boxes[game->statics_count] = (Rectangle)
+            {
+                entity->position.x + entity->collision.x,
+                entity->position.y + entity->collision.y,
+                entity->collision.width,
+                entity->collision.height
+            };
+            motion->collider_entities[game->statics_count] = query.index;
+            game->statics_count += 1;
+        }
+    }
+
+    // angn: then every dynamic collider's box, where it started the tick
+    U64 colliders_count = game->statics_count;
+    for(EntityQuery query = entity_query_make(game, ENTITY_STATIC_REQUIRED | ENTITY_STATIC_EXCLUDED, 0);
+            entity_query_next(&query);)
+    {
+        Entity *entity = &game->entities[query.index];
+        motion->collider_boxes[colliders_count] = (Rectangle)
+        {
+            entity->position.x + entity->collision.x,
+            entity->position.y + entity->collision.y,
+            entity->collision.width,
+            entity->collision.height
+        };
+        motion->collider_entities[colliders_count] = query.index;
+        motion->sweep_x[query.index] = 0.0f; // angn: woken up by a hit this tick, not swept yet
+        motion->sweep_y[query.index] = 0.0f;
+        colliders_count += 1;
+    }
+
+    motion->colliders_count = colliders_count;
+
+    //- angn: sweep the awake dynamic ones through the rest, in parallel batches
+    TempArena temp = temp_arena_begin(jobs->scratch[0]);
+    CollisionGrid grid = collision_grid_build(temp.arena, motion->collider_boxes, colliders_count);
+    CollisionSweepJob sweep_job = { .game = game, .jobs = jobs, .dt = dt, .grid = &grid };
+    sweep_job.movers = arena_push_array_no_zero(temp.arena, U32, colliders_count);
+    for(U64 ci = game->statics_count;
+            ci < colliders_count;
+            ci += 1)
+    {
+        if(!(game->entities[motion->collider_entities[ci]].flags.f[0] & sleeping_mask))
+        {
+            sweep_job.movers[sweep_job.movers_count] = Cast(U32, ci);
+            sweep_job.movers_count += 1;
+        }
+    }
+    sweep_job.results = arena_push_array_no_zero(temp.arena, SweepResult, sweep_job.movers_count);
+    jobs->run(jobs, collision_sweep_job, &sweep_job, (sweep_job.movers_count + COLLISION_JOB_MOVERS - 1) / COLLISION_JOB_MOVERS);
+
+    //- angn: merge in mover order, the integrate pass applies the resolved step
+    for(U64 mi = 0;
+            mi < sweep_job.movers_count;
+            mi += 1)
+    {
+        SweepResult *sweep = &sweep_job.results[mi];
+        Entity *entity = &game->entities[motion->collider_entities[sweep_job.movers[mi]]];
+        entity->velocity = sweep->velocity;
+        motion->sweep_x[entity->handle.index] = sweep->delta.x;
+        motion->sweep_y[entity->handle.index] = sweep->delta.y;
+
+        //- angn: whatever got hit wakes up, it starts moving next tick
+        for(U64 hi = 0;
+                hi < sweep->contacts_count;
+                hi += 1)
+        {
+            SweepContact *contact = &sweep->contacts[hi];
+            Entity *other = &game->entities[motion->collider_entities[contact->obstacle]];
+            entity_wake(game, other);
+            collision_event_push(context, (CollisionEvent)
+            {
+                .kind = CollisionEventKind_Contact,
+                .a = entity->handle,
+                .b = other->handle,
+                .normal = contact->normal,
+                .time = contact->time,
+            });
+        }
+    }
+    temp_arena_end(temp);
+}
+
+internal void
+game_system_integrate(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    F32 dt = context->dt;
+    EntityMotion *motion = &game->motion;
+    U64 sleeping_mask = EntityFlagsMask(EntityFlagsIndex_Sleeping);
+
+    //- angn: integrate, packed
+    // angn: NOTE: everyone collides against where the others started the tick
+    memset(motion->scale + first, 0, sizeof(motion->scale[0]) * (end - first));
+    for(U64 ei = first;
+            ei < end;
+            ei += 1)
+    {
+        Entity *entity = &game->entities[ei];
+        motion->position_x[ei] = entity->position.x;
+        motion->position_y[ei] = entity->position.y;
+        motion->velocity_x[ei] = entity->velocity.x;
+        motion->velocity_y[ei] = entity->velocity.y;
+    }
+    for(EntityQuery query = entity_query_make_range(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_ApplyVelocity), sleeping_mask, first, end);
+            entity_query_next(&query);)
+    {
+        motion->scale[query.index] = dt;
+    }
+    for(EntityQuery query = entity_query_make_range(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_ApplyVelocity) | EntityFlagsMask(EntityFlagsIndex_Collider), sleeping_mask, first, end);
+            entity_query_next(&query);)
+    {
+        motion->velocity_x[query.index] = motion->sweep_x[query.index];
+        motion->velocity_y[query.index] = motion->sweep_y[query.index];
+        motion->scale[query.index] = 1.0f;
+    }
+    motion_integrate(motion->position_x + first, motion->position_y + first,
+            motion->velocity_x + first, motion->velocity_y + first,
+            motion->scale + first, end - first);
+}
+
+internal void
+game_system_triggers(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    GameJobs *jobs = context->jobs;
+    EntityMotion *motion = &game->motion;
+    U64 colliders_count = motion->colliders_count;
+    (void)first;
+    (void)end;
+
+    //- angn: triggers, anything whose box met a trigger's box during the step
+    // angn: NOTE: swept in the trigger's frame, so a moving trigger (spells)
+    // catches colliders it flew past. entity->position is still the start
+    TempArena temps[GAME_WORKERS_MAX] = {0};
+    temps[0] = temp_arena_begin(jobs->scratch[0]);
+    Arena *arena = temps[0].arena;
+
+    CollisionTriggerJob trigger_job = { .game = game, .jobs = jobs };
+    trigger_job.triggers = arena_push_array_no_zero(arena, U32, ENTITIES_CAPACITY);
+    for(EntityQuery query = entity_query_make(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_Trigger), 0);
+            entity_query_next(&query);)
+    {
+        trigger_job.triggers[trigger_job.triggers_count] = Cast(U32, query.index);
+        trigger_job.triggers_count += 1;
+    }
+    if(trigger_job.triggers_count == 0)
+    {
+        temp_arena_end(temps[0]);
+        return;
+    }
+
+    //- angn: every collider's box over the whole step, start to end
+    Rectangle *swept_boxes = arena_push_array_no_zero(arena, Rectangle, colliders_count);
+    for(U64 ci = 0;
+            ci < colliders_count;
+            ci += 1)
+    {
+        U64 other_index = motion->collider_entities[ci];
+        Entity *other = &game->entities[other_index];
+        Rectangle box = motion->collider_boxes[ci];
+        Vector2 delta = { motion->position_x[other_index] - other->position.x, motion->position_y[other_index] - other->position.y };
+        swept_boxes[ci] = (Rectangle)
+        {
+            box.x + Min(delta.x, 0.0f),
+            box.y + Min(delta.y, 0.0f),
+            box.width + fabsf(delta.x),
+            box.height + fabsf(delta.y),
+        };
+    }
+    CollisionGrid grid = collision_grid_build(arena, swept_boxes, colliders_count);
+    trigger_job.grid = &grid;
+
+    trigger_job.results = arena_push_array_no_zero(arena, CollisionTriggerResult, trigger_job.triggers_count);
+    for(U64 wi = 0;
+            wi < jobs->workers_count;
+            wi += 1)
+    {
+        if(wi > 0)
+        {
+            temps[wi] = temp_arena_begin(jobs->scratch[wi]);
+        }
+        trigger_job.seen[wi] = arena_push_array(temps[wi].arena, U8, colliders_count);
+        trigger_job.candidates[wi] = arena_push_array_no_zero(temps[wi].arena, U32, colliders_count);
+    }
+    jobs->run(jobs, collision_trigger_job, &trigger_job, (trigger_job.triggers_count + COLLISION_JOB_MOVERS - 1) / COLLISION_JOB_MOVERS);
+
+    //- angn: merge in trigger order
+    for(U64 ti = 0;
+            ti < trigger_job.triggers_count;
+            ti += 1)
+    {
+        CollisionTriggerResult *result = &trigger_job.results[ti];
+        for(U64 ei = 0;
+                ei < result->events_count;
+                ei += 1)
+        {
+            collision_event_push(context, result->events[ei]);
+        }
+    }
+
+    for(U64 wi = jobs->workers_count;
+            wi > 0;
+            wi -= 1)
+    {
+        temp_arena_end(temps[wi - 1]);
+    }
+}
+
+internal void
+game_system_sleep(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    U64 sleeping_mask = EntityFlagsMask(EntityFlagsIndex_Sleeping);
+    (void)context;
+
+    //- angn: put bodies that came to rest to sleep
+    for(EntityQuery query = entity_query_make_range(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_ApplyVelocity), sleeping_mask, first, end);
+            entity_query_next(&query);)
+    {
+        Entity *entity = &game->entities[query.index];
+        if(Vector2LengthSqr(entity->velocity) >= SLEEP_SPEED * SLEEP_SPEED)
+        {
+            entity->still_ticks = 0;
+            continue;
+        }
+        entity->still_ticks += 1;
+        if(entity->still_ticks >= SLEEP_TICKS)
+        {
+            entity->velocity = (Vector2){0};
+            entity_flags_set_in(game, entity, EntityFlagsIndex_Sleeping);
+        }
+    }
+}
+
+internal void
+game_system_commit(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    EntityMotion *motion = &game->motion;
+    (void)context;
+
+    //- angn: commit the integrated positions
+    for(U64 ei = first;
+            ei < end;
+            ei += 1)
+    {
+        game->entities[ei].position = (Vector2){ motion->position_x[ei], motion->position_y[ei] };
+    }
+}
+
+internal void
+game_system_spell_hits(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    (void)first;
+    (void)end;
+
+    //- nick: spell hits
+    // angn: NOTE: spells never hit the player, that is who cast them. only an
+    // armed spell reacts at all, an unarmed one flies through like it always has
+    for(U64 ei = 0;
+            ei < context->collision_events_count;
+            ei += 1)
+    {
+        CollisionEvent *event = &context->collision_events[ei];
+        if(event->kind != CollisionEventKind_Trigger)
+        {
+            continue;
+        }
+
+        Entity *spell = get_entity_from_handle(game, event->a);
+        Entity *target = get_entity_from_handle(game, event->b);
+        if(!spell || !target ||
+                !entity_flags_contains(&spell->flags, EntityFlagsIndex_Alive) ||
+                !entity_flags_contains(&spell->flags, EntityFlagsIndex_Spell) ||
+                entity_flags_contains(&target->flags, EntityFlagsIndex_Player))
+        {
+            continue;
+        }
+
+        if(spell->spell_data.armed & SpellArmed_Explode)
+        {
+            sound_event_push(game, EventType_Explode, spell->sound_effects[EventType_Explode], spell->position);
+            Vector2 away = Vector2Normalize(Vector2Subtract(target->position, spell->position));
+            target->velocity = Vector2Add(target->velocity, Vector2Scale(away, SPELL_EXPLODE_IMPULSE));
+            entity_wake(game, target);
+
+            if(!(spell->spell_data.armed & SpellArmed_Pierce))
+            {
+                destroy_entity(game, spell->handle);
+            }
+        }
+    }
+}
+
+internal void
+game_system_despawn(
+        Game *game,
+        GameSystemContext *context,
+        U64 first,
+        U64 end)
+{
+    (void)context;
+    (void)first;
+    (void)end;
+
+    //- angn: spells far off-screen are not coming back, free the slot
+    Rectangle keep_rect =
+    {
+        -SPELL_DESPAWN_MARGIN,
+        -SPELL_DESPAWN_MARGIN,
+        game->screen.x + 2.0f * SPELL_DESPAWN_MARGIN,
+        game->screen.y + 2.0f * SPELL_DESPAWN_MARGIN,
+    };
+    for(EntityQuery query = entity_query_make(game, EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_Spell), 0);
+            entity_query_next(&query);)
+    {
+        Entity *entity = &game->entities[query.index];
+        if(!CheckCollisionPointRec(entity->position, keep_rect))
+        {
+            destroy_entity(game, entity->handle);
+        }
+    }
+}
+
+//~ angn: Systems
+// angn: NOTE: listed in the order the systems run. reads and writes are what
+// lets neighbours share a batch, a wrong declaration is a data race
+global GameSystem game_systems[GameSystem__Count] =
+{
+    [GameSystem_SpellEdit] = { game_system_spell_edit, GameSystemMode_Single,    0, GameComponent_SpellEditor },
+    [GameSystem_Friction]  = { game_system_friction,   GameSystemMode_Chunked,   GameComponent_Flags, GameComponent_Velocity | GameComponent_Motion },
+    [GameSystem_Animation] = { game_system_animation,  GameSystemMode_Chunked,   GameComponent_Flags, GameComponent_Transform | GameComponent_Animation },
+    [GameSystem_Input]     = { game_system_input,      GameSystemMode_Chunked,   GameComponent_Flags, GameComponent_Velocity | GameComponent_Animation | GameComponent_Flags },
+    [GameSystem_Shoot]     = { game_system_shoot,      GameSystemMode_Single,    GameComponent_All, GameComponent_All },
+    [GameSystem_SpellStep] = { game_system_spell_step, GameSystemMode_Single,    GameComponent_All, GameComponent_All },
+    [GameSystem_Collide]   = { game_system_collide,    GameSystemMode_Exclusive, GameComponent_All, GameComponent_All },
+    [GameSystem_Integrate] = { game_system_integrate,  GameSystemMode_Chunked,   GameComponent_Flags | GameComponent_Transform | GameComponent_Velocity, GameComponent_Motion },
+    [GameSystem_Triggers]  = { game_system_triggers,   GameSystemMode_Exclusive, GameComponent_Flags | GameComponent_Transform | GameComponent_Motion, GameComponent_Events },
+    [GameSystem_Sleep]     = { game_system_sleep,      GameSystemMode_Chunked,   GameComponent_Flags | GameComponent_Velocity, GameComponent_Velocity | GameComponent_Flags },
+    [GameSystem_Commit]    = { game_system_commit,     GameSystemMode_Chunked,   GameComponent_Motion, GameComponent_Transform },
+    [GameSystem_SpellHits] = { game_system_spell_hits, GameSystemMode_Single,    GameComponent_All, GameComponent_All },
+    [GameSystem_Despawn]   = { game_system_despawn,    GameSystemMode_Single,    GameComponent_All, GameComponent_All },
+};
+
+// angn: NOTE: runs on any worker, job_index picks the system and its chunk
+internal void
+game_system_batch_job(
+        void *params,
+        U64 job_index,
+        U64 worker_index)
+{
+    (void)worker_index;
+    GameSystemBatch *batch = (GameSystemBatch *)params;
+
+    U64 system_id = batch->first_system;
+    while(job_index >= batch->job_starts[system_id - batch->first_system + 1])
+    {
+        system_id += 1;
+    }
+    GameSystem *system = &game_systems[system_id];
+
+    U64 first = 0;
+    U64 end = ENTITIES_CAPACITY;
+    if(system->mode == GameSystemMode_Chunked)
+    {
+        first = (job_index - batch->job_starts[system_id - batch->first_system]) * GAME_SYSTEM_CHUNK_ENTITIES;
+        end = first + GAME_SYSTEM_CHUNK_ENTITIES;
+    }
+
+    GameJobs *jobs = batch->context->jobs;
+    U64 start = jobs->now_microseconds();
+    system->run(batch->game, batch->context, first, end);
+    AtomicAddU64(&batch->game->system_time_us[system_id], jobs->now_microseconds() - start);
+}
+
+internal void
+game_systems_run(
+        Game *game,
+        GameSystemContext *context)
+{
+    GameJobs *jobs = context->jobs;
+    for(U64 first_system = 0;
+            first_system < GameSystem__Count;)
+    {
+        //- angn: grow the batch until the next system touches what it writes or writes what it reads
+        GameSystemBatch batch = { .game = game, .context = context, .first_system = first_system, .end_system = first_system + 1 };
+        U64 reads = game_systems[first_system].reads;
+        U64 writes = game_systems[first_system].writes;
+        if(game_systems[first_system].mode != GameSystemMode_Exclusive)
+        {
+            for(;
+                    batch.end_system < GameSystem__Count;
+                    batch.end_system += 1)
+            {
+                GameSystem *system = &game_systems[batch.end_system];
+                if(system->mode == GameSystemMode_Exclusive ||
+                        (system->writes & (reads | writes)) ||
+                        (system->reads & writes))
+                {
+                    break;
+                }
+                reads |= system->reads;
+                writes |= system->writes;
+            }
+        }
+
+        //- angn: lay the jobs out in system order, with one worker that is the serial order
+        for(U64 system_id = batch.first_system;
+                system_id < batch.end_system;
+                system_id += 1)
+        {
+            U64 system_jobs = 1;
+            if(game_systems[system_id].mode == GameSystemMode_Chunked)
+            {
+                system_jobs = ENTITIES_CAPACITY / GAME_SYSTEM_CHUNK_ENTITIES;
+            }
+            batch.job_starts[system_id - batch.first_system + 1] = batch.job_starts[system_id - batch.first_system] + system_jobs;
+        }
+        U64 jobs_count = batch.job_starts[batch.end_system - batch.first_system];
+
+        if(game_systems[first_system].mode == GameSystemMode_Exclusive)
+        {
+            game_system_batch_job(&batch, 0, 0);
+        }
+        else
+        {
+            jobs->run(jobs, game_system_batch_job, &batch, jobs_count);
+        }
+        first_system = batch.end_system;
+    }
+}
+
+internal void
+game_update(
+        Game *game,
+        GameJobs *jobs,
+        Inputs inputs,
+        F32 dt, // angn: NOTE: technically always constant, useful
+                // for extra updates if required
+        GameTickOutput *output)
+{
+    //- angn: per tick buffers live under every system's own scratch use
+    TempArena temp = temp_arena_begin(jobs->scratch[0]);
+    GameSystemContext context = { .jobs = jobs, .inputs = inputs, .dt = dt };
+    context.collision_events = arena_push_array_no_zero(temp.arena, CollisionEvent, COLLISIONS_MAX);
+    game_systems_run(game, &context);
+
+    if(context.collision_events_dropped)
+    {
+        fprintf(stderr, "WARNING: COLLISIONS: dropped %llu events over COLLISIONS_MAX this tick\n",
+                Cast(unsigned long long, context.collision_events_dropped));
+    }
+    if(output)
+    {
+        output->collision_events = arena_push_array_no_zero(output->arena, CollisionEvent, context.collision_events_count);
+        memcpy(output->collision_events, context.collision_events, sizeof(CollisionEvent) * context.collision_events_count);
+        output->collision_events_count = context.collision_events_count;
+    }
+    temp_arena_end(temp);
+}
+
+internal void
+game_init(
+        Game *game,
+        Arena *arena)
+{
+    game->random = random_make(game->seed, 0);
+
+    //- daria: animations
+    // daria: TODO: have separate spritesheets or a single one
+    TextureName player_texture = TextureName_Creature;
+    Animation player_animation_down = animation_load(arena, player_texture, 1, 32);
+    player_animation_down.frames[0] = (AnimationFrame){ .sprite_map_index = 0, .duration = 1 };
+
+    Animation player_animation_up = animation_load(arena, player_texture, 1, 32);
+    player_animation_up.frames[0] = (AnimationFrame){ .sprite_map_index = 1, .duration = 1 };
+
+    Animation player_animation_left = animation_load(arena, player_texture, 1, 32);
+    player_animation_left.frames[0] = (AnimationFrame){ .sprite_map_index = 2, .duration = 1 };
+
+    Animation player_animation_right = animation_load(arena, player_texture, 1, 32);
+    player_animation_right.frames[0] = (AnimationFrame){ .sprite_map_index = 3, .duration = 1 };
+
+    Animation player_animation_idle = animation_load(arena, player_texture, 4, 32);
+    player_animation_idle.frames[0] = (AnimationFrame){ .sprite_map_index = 0, .duration = 1 };
+    player_animation_idle.frames[1] = (AnimationFrame){ .sprite_map_index = 1, .duration = 1 };
+    player_animation_idle.frames[2] = (AnimationFrame){ .sprite_map_index = 2, .duration = 1 };
+    player_animation_idle.frames[3] = (AnimationFrame){ .sprite_map_index = 3, .duration = 1 };
+
+    //- angn: entities
+    {
+        Entity *player = alloc_entity(game);
+        Assert(player);
+        entity_flags_set_in(game, player, EntityFlagsIndex_WASDMotion);
+        entity_flags_set_in(game, player, EntityFlagsIndex_ApplyVelocity);
+        entity_flags_set_in(game, player, EntityFlagsIndex_ApplyFriction);
+        entity_flags_set_in(game, player, EntityFlagsIndex_Player);
+        entity_flags_set_in(game, player, EntityFlagsIndex_RenderTexture);
+        entity_flags_set_in(game, player, EntityFlagsIndex_ShootOnClick);
+        entity_flags_set_in(game, player, EntityFlagsIndex_Collider);
+
+        player->position = (Vector2){ Cast(F32, game->screen.x) * 0.5f, Cast(F32, game->screen.y) * 0.5f };
+        player->prev_position = player->position;
+        player->friction = 15.0f;
+
+        player->sound_effects[EventType_Shoot] = SoundName_CatMeow;
+        player->sound_effects[EventType_Explode] = SoundName_CatMeow; // angn: TODO: an actual bang
+        player->player_state = PlayerState_Up;
+
+        player->animations[PlayerState_Down] = player_animation_down;
+        player->animations[PlayerState_Up] = player_animation_up;
+        player->animations[PlayerState_Left] = player_animation_left;
+        player->animations[PlayerState_Right] = player_animation_right;
+        player->animations[PlayerState_Idle] = player_animation_idle;
+    }
+}
+
+//~ angn: Game API
+internal void
+game_load(
+        OS_SystemInfo *system_info)
+{
+    // angn: the same struct when the game is built into the host
+    OS_SystemInfo *info = os_get_system_info();
+    if(info != system_info)
+    {
+        *info = *system_info;
+    }
+}
+
+#if BUILD_HOT_RELOAD
+exported
+#else
+internal
+#endif
+GameApi
+game_get_api(void)
+{
+    GameApi api =
+    {
+        .version = GAME_API_VERSION,
+        .game_size = sizeof(Game),
+        .load = game_load,
+        .init = game_init,
+        .update = game_update,
+    };
+    return(api);
+}
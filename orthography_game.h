@@ -0,0 +1,1288 @@
+#ifndef ORTHOGRAPHY_GAME_H
+#define ORTHOGRAPHY_GAME_H
+
+#include "orthography.h"
+#include <stdlib.h>
+
+//~ angn: EventType
+typedef enum : U64
+{
+    EventType_Shoot, // angn: i have no idea what we want
+    EventType_Explode,
+    EventType__Count,
+} EventType;
+
+//~ daria: Render/Animation
+#define MAX_ANIMATIONS 1
+#define ANIMATION_CAPACITY 5
+
+//~ daria: Audio
+#define SOUNDS_LIST \
+    SOUNDS_LIST_X(CatMeow, "audio/Cat_Meow.wav") \
+
+typedef enum : U32
+{
+#define SOUNDS_LIST_X(n, path) SoundName_##n,
+    SOUNDS_LIST
+#undef SOUNDS_LIST_X
+    SoundName__Count,
+} SoundName;
+
+global char *sound_names[] =
+{
+#define SOUNDS_LIST_X(n, path) path,
+    SOUNDS_LIST
+#undef SOUNDS_LIST_X
+};
+
+//~ daria: Textures
+#define TEXTURES_LIST \
+    TEXTURES_LIST_X(Creature, "textures/Creature.png") \
+
+typedef enum : U32
+{
+#define TEXTURES_LIST_X(n, path) TextureName_##n,
+    TEXTURES_LIST
+#undef TEXTURES_LIST_X
+    TextureName__Count,
+} TextureName;
+
+global char *texture_names[] =
+{
+#define TEXTURES_LIST_X(n, path) path,
+    TEXTURES_LIST
+#undef TEXTURES_LIST_X
+};
+
+//~ angn: Sound events
+// angn: the simulation only queues these, the main thread decides what plays
+#define SOUND_EVENTS_MAX 64 // per tick
+
+typedef struct SoundEvent SoundEvent;
+struct SoundEvent
+{
+    EventType event;
+    SoundName name;
+    Vector2 position;
+};
+
+//~ daria: Animations
+// daria: TODO: place this elsewhere
+typedef struct AnimationFrame AnimationFrame;
+struct AnimationFrame
+{
+    U64 sprite_map_index; // starting frame index
+    U32 duration; // per frame
+};
+
+typedef struct Animation Animation;
+struct Animation
+{
+    TextureName texture; // angn: resolved by the asset system when drawing
+
+    AnimationFrame *frames;
+    // left to right, top to bottom
+    U32 frames_size;
+    U32 current_frame;
+    U32 frame_duration;
+    U32 cell_size; // px
+};
+
+internal Animation
+animation_load(
+        Arena *arena,
+        TextureName texture,
+        U8 frames_size,
+        U8 cell_size)
+{
+    // Animation
+    Animation a =
+    {
+        .texture = texture,
+        .frames = arena_push_array(arena, AnimationFrame, frames_size),
+        .frames_size = frames_size,
+        .cell_size = cell_size
+    };
+
+    return a;
+}
+
+internal void
+animation_next_frame(
+        Animation *a)
+{
+    if(a->frame_duration >= a->frames[a->current_frame].duration)
+    {
+        a->current_frame = (a->current_frame + 1) % a->frames_size;
+        a->frame_duration = 0;
+    }
+}
+
+//~ angn: Inputs
+typedef enum InputState : U8
+{
+    InputState_Down = (1<<0),
+    InputState_Up = (1<<1),
+    InputState_Pressed = (1<<2),
+    InputState_Released = (1<<3),
+} InputState;
+
+typedef enum InputTypes : U64
+{
+    InputTypes_W,
+    InputTypes_A,
+    InputTypes_S,
+    InputTypes_D,
+    InputTypes_Select_Spell_0,
+    InputTypes_Select_Spell_1,
+    InputTypes_Select_Spell_2,
+    InputTypes_Shoot,
+    InputTypes__Count,
+} InputTypes;
+
+typedef InputState Inputs[InputTypes__Count];
+typedef KeyboardKey KeyMap[InputTypes__Count];
+
+//~ nick: Spells
+#define SPELL_SLOTS_MAX 16
+#define SPELL_PROGRAMS_MAX 8
+
+typedef enum : U8 {
+    SpellType_Bomb,
+    SpellType_Bolt,
+    SpellType_Loop_Bolt,
+    SpellType_Bounce_Bolt,
+    SpellType__Count,
+} SpellType;
+
+typedef enum : U8 {
+    //- nick: movement spells
+    SpellInstruction_Accel_Forward,
+    SpellInstruction_Accel_Left,
+    SpellInstruction_Accel_Right,
+    SpellInstruction_Accel_Back,
+    SpellInstruction_Turn_Left,
+    SpellInstruction_Turn_Right,
+    SpellInstruction_Turn_About,
+    SpellInstruction_Face_Enemy,
+    SpellInstruction_Face_Player,
+    SpellInstruction_Abeam_Enemy,
+    SpellInstruction_Abeam_Player,
+
+    //- nick: utility spells
+    SpellInstruction_Duplicate,
+    SpellInstruction_Death_Duplicate,
+    SpellInstruction_Burst_Duplicate,
+    SpellInstruction_Increase_Lifetime,
+    SpellInstruction_Decrease_Lifetime,
+    SpellInstruction_Destroy_Spell,
+    SpellInstruction_Increase_Execution_Speed,
+    SpellInstruction_Decrease_Execution_Speed,
+    SpellInstruction_Loop,
+
+    //- nick: effect spells
+    SpellInstruction_Arm_Pierce,
+    SpellInstruction_Arm_Explode,
+    SpellInstruction_Do_Sear,
+    SpellInstruction_Do_Flameburst,
+
+    SpellInstruction__Count,
+} SpellInstruction;
+
+typedef struct SpellData SpellData;
+struct SpellData {
+    SpellType type;     // nick: projectile type
+    U8 program_index;   // nick: which spell program are we following
+    U8 program_length;  // nick: number of instruction slots used
+    U8 slot_index;      // nick: which slot we're on
+    U8 lifetime;        // nick: remaining lifetime in steps
+    U8 tick;            // nick: increments each update
+    U8 ticks_per_step;  // nick: step period in ticks
+    F32 rotation;
+    F32 prev_rotation;  // angn: rotation at the start of the last tick
+    U8 armed;           // angn: SpellArmed flags, what happens when it hits something
+};
+
+typedef enum : U8
+{
+    SpellArmed_Pierce  = (1 << 0), // angn: an exploding spell keeps going instead of going away
+    SpellArmed_Explode = (1 << 1), // angn: makes a noise, knocks back what it hits and goes away
+} SpellArmed;
+
+//~ angn: Handle
+typedef struct Handle Handle;
+struct Handle
+{
+    U64 index;
+    U64 gen;
+};
+
+//~ angn: EntityFlags
+typedef struct EntityFlags EntityFlags;
+struct EntityFlags
+{
+    U64 f[1];
+};
+
+typedef enum : U64
+{
+    EntityFlagsIndex_Alive,
+    EntityFlagsIndex_ApplyVelocity,
+    EntityFlagsIndex_WASDMotion,
+    EntityFlagsIndex_Collider,
+    EntityFlagsIndex_Trigger,
+    EntityFlagsIndex_ApplyFriction,
+    EntityFlagsIndex_ApplyBounce,
+    EntityFlagsIndex_ShootOnClick,
+    EntityFlagsIndex_Player,
+    EntityFlagsIndex_RenderTexture,
+    EntityFlagsIndex_Spell,
+    EntityFlagsIndex_Sleeping, // angn: came to rest, skipped by friction, sweeps and integration
+    EntityFlagsIndex__Count,
+} EntityFlagsIndex;
+
+#define EntityFlagsMask(index) (1ull << (index)) // angn: for queries, EntityFlags::f[0]
+
+#define EntityFlags_Assert_IndexValid(index) do { \
+    Assert(index < EntityFlagsIndex__Count); \
+    U64 max_number_of_bits = sizeof(MemberOf(EntityFlags, f)) * 8; \
+    Assert(index < max_number_of_bits); \
+} while(0)
+
+internal void
+entity_flags_set(
+        EntityFlags *flags,
+        EntityFlagsIndex index)
+{
+    EntityFlags_Assert_IndexValid(index);
+    U64 number_of_bits_in_cell = sizeof(*MemberOf(EntityFlags, f)) * 8;
+    U64 quo = index / number_of_bits_in_cell;
+    U64 rem = index % number_of_bits_in_cell;
+    flags->f[quo] |= (1ull << rem);
+}
+
+internal void
+entity_flags_unset(
+        EntityFlags *flags,
+        EntityFlagsIndex index)
+{
+    EntityFlags_Assert_IndexValid(index);
+    U64 number_of_bits_in_cell = sizeof(*MemberOf(EntityFlags, f)) * 8;
+    U64 quo = index / number_of_bits_in_cell;
+    U64 rem = index % number_of_bits_in_cell;
+    flags->f[quo] &= ~(1ull << rem);
+}
+
+internal B32
+entity_flags_contains(
+        EntityFlags *flags,
+        EntityFlagsIndex index)
+{
+    EntityFlags_Assert_IndexValid(index);
+    U64 number_of_bits_in_cell = sizeof(*MemberOf(EntityFlags, f)) * 8;
+    U64 quo = index / number_of_bits_in_cell;
+    U64 rem = index % number_of_bits_in_cell;
+    return((flags->f[quo] >> rem) & 1);
+}
+
+//~ daria: entity states
+typedef U64 EntityState;
+typedef enum : EntityState
+{
+    PlayerState_Idle,
+    PlayerState_Down,
+    PlayerState_Up,
+    PlayerState_Left,
+    PlayerState_Right,
+} PlayerState;
+
+//~ angn: Entities
+typedef struct Entity Entity;
+struct Entity
+{
+    EntityFlags flags;
+    Handle handle;
+
+    //- angn: state
+    EntityState player_state;
+
+    //- angn: motion
+    Vector2 position;
+    Vector2 prev_position; // angn: position at the start of the last tick, for render interpolation
+    Vector2 velocity;
+    F32 friction;
+    Rectangle collision;
+    U64 still_ticks; // angn: ticks in a row under SLEEP_SPEED
+
+    //- nick: spells
+    SpellData spell_data;
+
+    //- angn: audio
+    SoundName sound_effects[EventType__Count];
+
+    //- angn: TODO: render / animations
+    Animation animations[ANIMATION_CAPACITY];
+};
+
+//~ nick: Physics
+// angn: per tick, on the jobs' scratch arena. every mover stopping on every
+// slide still fits, only a crowd of overlapping triggers can run past it,
+// and that is logged
+#define COLLISIONS_MAX (ENTITIES_CAPACITY * SWEEP_ITERATIONS_MAX)
+
+//~ angn: Swept collision
+// angn: boxes are swept along their whole step and stopped at the time of
+// impact, so nothing tunnels through a collider thinner than one step no
+// matter how fast it goes. obstacles are where they were at the start of the tick
+#define SWEEP_ITERATIONS_MAX 4  // angn: slides per step, a corner takes two
+#define SWEEP_SKIN           0.01f // px of overlap still treated as touching, eats rounding
+
+typedef struct SweepHit SweepHit;
+struct SweepHit
+{
+    B32 hit;
+    F32 time;       // angn: fraction of `delta` travelled before contact, [0, 1]
+    Vector2 normal; // angn: face of the target that was hit, points at the mover
+};
+
+typedef struct SweepContact SweepContact;
+struct SweepContact
+{
+    U64 obstacle;   // angn: index into the obstacles
+    F32 time;       // angn: fraction of the whole step, not of what was left of it
+    Vector2 normal;
+};
+
+typedef struct SweepResult SweepResult;
+struct SweepResult
+{
+    Vector2 delta;    // angn: how far the box actually moves this step
+    Vector2 velocity; // angn: velocity after the response
+    SweepContact contacts[SWEEP_ITERATIONS_MAX];
+    U64 contacts_count;
+};
+
+internal SweepHit
+sweep_aabb(
+        Rectangle moving,
+        Vector2 delta,
+        Rectangle target)
+{
+    SweepHit result = {0};
+
+    F32 moving_min[2] = { moving.x, moving.y };
+    F32 moving_max[2] = { moving.x + moving.width, moving.y + moving.height };
+    F32 target_min[2] = { target.x, target.y };
+    F32 target_max[2] = { target.x + target.width, target.y + target.height };
+    F32 deltas[2] = { delta.x, delta.y };
+
+    F32 entry = -INFINITY;
+    F32 exit = INFINITY;
+    F32 entry_gap = 0.0f; // angn: distance to the entry face, negative when already past it
+    Vector2 normal = {0};
+    B32 moves = 0;
+
+    for(U64 axis = 0;
+            axis < 2;
+            axis += 1)
+    {
+        if(deltas[axis] == 0.0f)
+        {
+            //- angn: still on this axis, the slabs have to overlap for the whole step
+            if(moving_max[axis] <= target_min[axis] || moving_min[axis] >= target_max[axis])
+            {
+                return(result);
+            }
+            continue;
+        }
+
+        moves = 1;
+        B32 positive = deltas[axis] > 0.0f;
+        F32 near_gap = positive ? target_min[axis] - moving_max[axis] : moving_min[axis] - target_max[axis];
+        F32 far_gap = positive ? target_max[axis] - moving_min[axis] : moving_max[axis] - target_min[axis];
+        F32 speed = positive ? deltas[axis] : -deltas[axis];
+        F32 axis_entry = near_gap / speed;
+        F32 axis_exit = far_gap / speed;
+
+        if(axis_entry > entry)
+        {
+            entry = axis_entry;
+            entry_gap = near_gap;
+            normal = (Vector2){0};
+            if(axis == 0) { normal.x = positive ? -1.0f : 1.0f; }
+            else          { normal.y = positive ? -1.0f : 1.0f; }
+        }
+        if(axis_exit < exit)
+        {
+            exit = axis_exit;
+        }
+    }
+
+    // angn: NOTE: a box that starts deeper than the skin is left alone rather
+    // than snapped out, that is how spells leave whoever cast them
+    if(moves && entry <= exit && entry <= 1.0f && exit > 0.0f && entry_gap >= -SWEEP_SKIN)
+    {
+        result.hit = 1;
+        result.time = entry > 0.0f ? entry : 0.0f;
+        result.normal = normal;
+    }
+
+    return(result);
+}
+
+// angn: moves `box` by `velocity * dt` through `obstacles`, skipping `skip`
+// (the mover itself, or obstacles_count). every hit either slides along the
+// face or, with `bounce`, reflects off it, then the rest of the step goes on
+internal SweepResult
+sweep_move(
+        Rectangle box,
+        Vector2 velocity,
+        F32 dt,
+        Rectangle *obstacles,
+        U64 obstacles_count,
+        U64 skip,
+        B32 bounce)
+{
+    SweepResult result = {0};
+    result.velocity = velocity;
+    Vector2 remaining = Vector2Scale(velocity, dt);
+    F32 step_time = 0.0f;
+
+    for(U64 iteration = 0;
+            iteration < SWEEP_ITERATIONS_MAX && (remaining.x != 0.0f || remaining.y != 0.0f);
+            iteration += 1)
+    {
+        SweepHit best = {0};
+        U64 best_index = obstacles_count;
+        for(U64 oi = 0;
+                oi < obstacles_count;
+                oi += 1)
+        {
+            if(oi == skip)
+            {
+                continue;
+            }
+            SweepHit hit = sweep_aabb(box, remaining, obstacles[oi]);
+            if(hit.hit && (!best.hit || hit.time < best.time))
+            {
+                best = hit;
+                best_index = oi;
+            }
+        }
+
+        F32 time = best.hit ? best.time : 1.0f;
+        Vector2 travelled = Vector2Scale(remaining, time);
+        box.x += travelled.x;
+        box.y += travelled.y;
+        result.delta = Vector2Add(result.delta, travelled);
+
+        if(!best.hit)
+        {
+            break;
+        }
+
+        step_time += (1.0f - step_time) * time;
+        result.contacts[result.contacts_count] = (SweepContact){ .obstacle = best_index, .time = step_time, .normal = best.normal };
+        result.contacts_count += 1;
+
+        //- angn: response, drop (slide) or flip (bounce) the part going into the face
+        F32 response = bounce ? 2.0f : 1.0f;
+        Vector2 left = Vector2Scale(remaining, 1.0f - time);
+        F32 left_into = Vector2DotProduct(left, best.normal);
+        F32 velocity_into = Vector2DotProduct(result.velocity, best.normal);
+        if(left_into < 0.0f)
+        {
+            left = Vector2Subtract(left, Vector2Scale(best.normal, response * left_into));
+        }
+        if(velocity_into < 0.0f)
+        {
+            result.velocity = Vector2Subtract(result.velocity, Vector2Scale(best.normal, response * velocity_into));
+        }
+        remaining = left;
+    }
+
+    return(result);
+}
+
+//~ angn: Broadphase
+// angn: a hashed uniform grid over collider boxes, so a sweep only tests
+// what is near its path instead of every collider
+// angn: NOTE: queries hand candidates back sorted by index, so the first
+// hit at equal time is the same one a scan over every collider finds
+#define COLLISION_CELL_SIZE      64.0f
+#define COLLISION_GRID_BUCKETS   4096 // angn: power of two
+#define COLLISION_CELL_SPAN_MAX  4    // angn: cells per axis, bigger boxes go on the oversized list
+#define COLLISION_QUERY_SPAN_MAX 16   // angn: cells per axis, bigger queries just take every collider
+
+typedef struct CollisionGrid CollisionGrid;
+struct CollisionGrid
+{
+    U32 *bucket_starts; // angn: COLLISION_GRID_BUCKETS + 1, items of bucket b are [starts[b], starts[b + 1])
+    U32 *items;         // angn: box indices
+    U32 *oversized;
+    U64 oversized_count;
+    U64 boxes_count;
+};
+
+typedef struct CollisionCells CollisionCells;
+struct CollisionCells
+{
+    S32 x0, y0;
+    S32 x1, y1; // angn: inclusive
+};
+
+internal S32
+collision_cell_from_coordinate(
+        F32 coordinate)
+{
+    F32 cell = floorf(coordinate / COLLISION_CELL_SIZE);
+    cell = Clamp(cell, -1000000.0f, 1000000.0f); // angn: far off spells, and no UB on the cast
+    return(Cast(S32, cell));
+}
+
+internal CollisionCells
+collision_cells_from_rect(
+        Rectangle rect)
+{
+    CollisionCells result =
+    {
+        collision_cell_from_coordinate(rect.x),
+        collision_cell_from_coordinate(rect.y),
+        collision_cell_from_coordinate(rect.x + rect.width),
+        collision_cell_from_coordinate(rect.y + rect.height),
+    };
+    return(result);
+}
+
+internal U32
+collision_bucket_from_cell(
+        S32 x,
+        S32 y)
+{
+    U32 hash = (Cast(U32, x) * 73856093u) ^ (Cast(U32, y) * 19349663u);
+    return(hash & (COLLISION_GRID_BUCKETS - 1));
+}
+
+internal CollisionGrid
+collision_grid_build(
+        Arena *arena,
+        Rectangle *boxes,
+        U64 boxes_count)
+{
+    CollisionGrid grid = {0};
+    grid.boxes_count = boxes_count;
+    grid.bucket_starts = arena_push_array(arena, U32, COLLISION_GRID_BUCKETS + 1);
+    grid.oversized = arena_push_array_no_zero(arena, U32, boxes_count);
+
+    //- angn: count
+    U64 items_count = 0;
+    for(U64 bi = 0;
+            bi < boxes_count;
+            bi += 1)
+    {
+        CollisionCells cells = collision_cells_from_rect(boxes[bi]);
+        if(cells.x1 - cells.x0 >= COLLISION_CELL_SPAN_MAX || cells.y1 - cells.y0 >= COLLISION_CELL_SPAN_MAX)
+        {
+            grid.oversized[grid.oversized_count] = Cast(U32, bi);
+            grid.oversized_count += 1;
+            continue;
+        }
+        for(S32 y = cells.y0;
+                y <= cells.y1;
+                y += 1)
+        {
+            for(S32 x = cells.x0;
+                    x <= cells.x1;
+                    x += 1)
+            {
+                grid.bucket_starts[collision_bucket_from_cell(x, y) + 1] += 1;
+                items_count += 1;
+            }
+        }
+    }
+
+    //- angn: prefix sum, then fill in box order so every bucket stays sorted
+    for(U64 b = 0;
+            b < COLLISION_GRID_BUCKETS;
+            b += 1)
+    {
+        grid.bucket_starts[b + 1] += grid.bucket_starts[b];
+    }
+    U32 *cursors = arena_push_array_no_zero(arena, U32, COLLISION_GRID_BUCKETS);
+    memcpy(cursors, grid.bucket_starts, sizeof(U32) * COLLISION_GRID_BUCKETS);
+    grid.items = arena_push_array_no_zero(arena, U32, items_count);
+    for(U64 bi = 0;
+            bi < boxes_count;
+            bi += 1)
+    {
+        CollisionCells cells = collision_cells_from_rect(boxes[bi]);
+        if(cells.x1 - cells.x0 >= COLLISION_CELL_SPAN_MAX || cells.y1 - cells.y0 >= COLLISION_CELL_SPAN_MAX)
+        {
+            continue;
+        }
+        for(S32 y = cells.y0;
+                y <= cells.y1;
+                y += 1)
+        {
+            for(S32 x = cells.x0;
+                    x <= cells.x1;
+                    x += 1)
+            {
+                U32 bucket = collision_bucket_from_cell(x, y);
+                grid.items[cursors[bucket]] = Cast(U32, bi);
+                cursors[bucket] += 1;
+            }
+        }
+    }
+
+    return(grid);
+}
+
+// angn: every box that might touch `region`, but `skip`, sorted by index.
+// `seen` is one byte per box, all zero, and is left all zero
+internal U64
+collision_grid_query(
+        CollisionGrid *grid,
+        Rectangle region,
+        U64 skip,
+        U8 *seen,
+        U32 *candidates)
+{
+    U64 count = 0;
+    CollisionCells cells = collision_cells_from_rect(region);
+    if(cells.x1 - cells.x0 >= COLLISION_QUERY_SPAN_MAX || cells.y1 - cells.y0 >= COLLISION_QUERY_SPAN_MAX)
+    {
+        for(U64 bi = 0;
+                bi < grid->boxes_count;
+                bi += 1)
+        {
+            if(bi != skip)
+            {
+                candidates[count] = Cast(U32, bi);
+                count += 1;
+            }
+        }
+        return(count);
+    }
+
+    for(S32 y = cells.y0;
+            y <= cells.y1;
+            y += 1)
+    {
+        for(S32 x = cells.x0;
+                x <= cells.x1;
+                x += 1)
+        {
+            U32 bucket = collision_bucket_from_cell(x, y);
+            for(U32 ii = grid->bucket_starts[bucket];
+                    ii < grid->bucket_starts[bucket + 1];
+                    ii += 1)
+            {
+                U32 bi = grid->items[ii];
+                if(!seen[bi] && bi != skip)
+                {
+                    seen[bi] = 1;
+                    candidates[count] = bi;
+                    count += 1;
+                }
+            }
+        }
+    }
+    for(U64 oi = 0;
+            oi < grid->oversized_count;
+            oi += 1)
+    {
+        U32 bi = grid->oversized[oi];
+        if(!seen[bi] && bi != skip)
+        {
+            seen[bi] = 1;
+            candidates[count] = bi;
+            count += 1;
+        }
+    }
+
+    //- angn: sort, and clear `seen` for the next query
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        U32 candidate = candidates[i];
+        seen[candidate] = 0;
+        U64 j = i;
+        for(;
+                j > 0 && candidates[j - 1] > candidate;
+                j -= 1)
+        {
+            candidates[j] = candidates[j - 1];
+        }
+        candidates[j] = candidate;
+    }
+    return(count);
+}
+
+//~ angn: Collision events
+// angn: the collision pass only records what touched what, this tick, and
+// the systems after it (spell hits, ...) read the stream in bulk instead of
+// scanning entity pairs themselves
+// angn: NOTE: `a` is the one that moved into (Contact) or the trigger (Trigger)
+typedef enum : U8
+{
+    CollisionEventKind_Contact, // angn: a swept mover was stopped by `b`
+    CollisionEventKind_Trigger, // angn: `b` overlapped trigger `a` some time during the step
+    CollisionEventKind__Count,
+} CollisionEventKind;
+
+typedef struct CollisionEvent CollisionEvent;
+struct CollisionEvent
+{
+    CollisionEventKind kind;
+    Handle a;
+    Handle b;
+    Vector2 normal; // angn: face of `b` that was hit, zero for triggers that started inside
+    F32 time;       // angn: time of impact as a fraction of the tick
+};
+
+//~ angn: Sleeping
+// angn: a body that stayed under SLEEP_SPEED for SLEEP_TICKS ticks gets
+// EntityFlagsIndex_Sleeping and its velocity zeroed. input, spell
+// instructions and being hit wake it again (entity_wake)
+#define SLEEP_SPEED 1.0f // px/s
+#define SLEEP_TICKS 30
+
+//~ angn: Spells that left the screen
+#define SPELL_DESPAWN_MARGIN 512.0f // px past the screen edge before a spell is destroyed
+
+//~ angn: Spell hits
+#define SPELL_EXPLODE_IMPULSE 400.0f // px/s added to whatever an armed explode spell hits
+
+//~ angn: Motion
+// angn: friction and integration run over packed arrays instead of per entity,
+// a flag that is off is a 0 scale in that lane, so the kernels never branch
+// angn: NOTE: the wide paths do exactly the scalar math, a multiply then a
+// subtract/add, so every path lands on the same bits
+
+internal void
+motion_apply_friction_scalar(
+        F32 *velocity_x,
+        F32 *velocity_y,
+        F32 *friction_dt,
+        U64 count)
+{
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        // angn: NOTE: separate statements so the compiler cannot fuse them
+        F32 slowdown_x = velocity_x[i] * friction_dt[i];
+        F32 slowdown_y = velocity_y[i] * friction_dt[i];
+        velocity_x[i] -= slowdown_x;
+        velocity_y[i] -= slowdown_y;
+    }
+}
+
+internal void
+motion_integrate_scalar(
+        F32 *position_x,
+        F32 *position_y,
+        F32 *velocity_x,
+        F32 *velocity_y,
+        F32 *velocity_dt,
+        U64 count)
+{
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        F32 step_x = velocity_x[i] * velocity_dt[i];
+        F32 step_y = velocity_y[i] * velocity_dt[i];
+        position_x[i] += step_x;
+        position_y[i] += step_y;
+    }
+}
+
+// angn: v -= v * friction_dt
+internal void
+motion_apply_friction(
+        F32 *velocity_x,
+        F32 *velocity_y,
+        F32 *friction_dt,
+        U64 count)
+{
+    U64 i = 0;
+#if SIMD_AVX2
+    for(;
+            i + 8 <= count;
+            i += 8)
+    {
+        __m256 scale = _mm256_loadu_ps(friction_dt + i);
+        __m256 x = _mm256_loadu_ps(velocity_x + i);
+        __m256 y = _mm256_loadu_ps(velocity_y + i);
+        _mm256_storeu_ps(velocity_x + i, _mm256_sub_ps(x, _mm256_mul_ps(x, scale)));
+        _mm256_storeu_ps(velocity_y + i, _mm256_sub_ps(y, _mm256_mul_ps(y, scale)));
+    }
+#elif SIMD_SSE2
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        __m128 scale = _mm_loadu_ps(friction_dt + i);
+        __m128 x = _mm_loadu_ps(velocity_x + i);
+        __m128 y = _mm_loadu_ps(velocity_y + i);
+        _mm_storeu_ps(velocity_x + i, _mm_sub_ps(x, _mm_mul_ps(x, scale)));
+        _mm_storeu_ps(velocity_y + i, _mm_sub_ps(y, _mm_mul_ps(y, scale)));
+    }
+#elif SIMD_NEON
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        float32x4_t scale = vld1q_f32(friction_dt + i);
+        float32x4_t x = vld1q_f32(velocity_x + i);
+        float32x4_t y = vld1q_f32(velocity_y + i);
+        vst1q_f32(velocity_x + i, vsubq_f32(x, vmulq_f32(x, scale)));
+        vst1q_f32(velocity_y + i, vsubq_f32(y, vmulq_f32(y, scale)));
+    }
+#endif
+    motion_apply_friction_scalar(velocity_x + i, velocity_y + i, friction_dt + i, count - i);
+}
+
+// angn: p += v * velocity_dt
+internal void
+motion_integrate(
+        F32 *position_x,
+        F32 *position_y,
+        F32 *velocity_x,
+        F32 *velocity_y,
+        F32 *velocity_dt,
+        U64 count)
+{
+    U64 i = 0;
+#if SIMD_AVX2
+    for(;
+            i + 8 <= count;
+            i += 8)
+    {
+        __m256 scale = _mm256_loadu_ps(velocity_dt + i);
+        __m256 x = _mm256_loadu_ps(position_x + i);
+        __m256 y = _mm256_loadu_ps(position_y + i);
+        x = _mm256_add_ps(x, _mm256_mul_ps(_mm256_loadu_ps(velocity_x + i), scale));
+        y = _mm256_add_ps(y, _mm256_mul_ps(_mm256_loadu_ps(velocity_y + i), scale));
+        _mm256_storeu_ps(position_x + i, x);
+        _mm256_storeu_ps(position_y + i, y);
+    }
+#elif SIMD_SSE2
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        __m128 scale = _mm_loadu_ps(velocity_dt + i);
+        __m128 x = _mm_loadu_ps(position_x + i);
+        __m128 y = _mm_loadu_ps(position_y + i);
+        x = _mm_add_ps(x, _mm_mul_ps(_mm_loadu_ps(velocity_x + i), scale));
+        y = _mm_add_ps(y, _mm_mul_ps(_mm_loadu_ps(velocity_y + i), scale));
+        _mm_storeu_ps(position_x + i, x);
+        _mm_storeu_ps(position_y + i, y);
+    }
+#elif SIMD_NEON
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        float32x4_t scale = vld1q_f32(velocity_dt + i);
+        float32x4_t x = vld1q_f32(position_x + i);
+        float32x4_t y = vld1q_f32(position_y + i);
+        x = vaddq_f32(x, vmulq_f32(vld1q_f32(velocity_x + i), scale));
+        y = vaddq_f32(y, vmulq_f32(vld1q_f32(velocity_y + i), scale));
+        vst1q_f32(position_x + i, x);
+        vst1q_f32(position_y + i, y);
+    }
+#endif
+    motion_integrate_scalar(position_x + i, position_y + i, velocity_x + i, velocity_y + i, velocity_dt + i, count - i);
+}
+
+//~ angn: System ids
+// angn: in the order game_update runs them, see Systems
+#define GAME_SYSTEMS_LIST \
+    GAME_SYSTEMS_LIST_X(SpellEdit, "spell edit") \
+    GAME_SYSTEMS_LIST_X(Friction,  "friction") \
+    GAME_SYSTEMS_LIST_X(Animation, "animation") \
+    GAME_SYSTEMS_LIST_X(Input,     "input") \
+    GAME_SYSTEMS_LIST_X(Shoot,     "shoot") \
+    GAME_SYSTEMS_LIST_X(SpellStep, "spell step") \
+    GAME_SYSTEMS_LIST_X(Collide,   "collide") \
+    GAME_SYSTEMS_LIST_X(Integrate, "integrate") \
+    GAME_SYSTEMS_LIST_X(Triggers,  "triggers") \
+    GAME_SYSTEMS_LIST_X(Sleep,     "sleep") \
+    GAME_SYSTEMS_LIST_X(Commit,    "commit") \
+    GAME_SYSTEMS_LIST_X(SpellHits, "spell hits") \
+    GAME_SYSTEMS_LIST_X(Despawn,   "despawn") \
+
+typedef enum : U64
+{
+#define GAME_SYSTEMS_LIST_X(n, name) GameSystem_##n,
+    GAME_SYSTEMS_LIST
+#undef GAME_SYSTEMS_LIST_X
+    GameSystem__Count,
+} GameSystemId;
+
+global char *game_system_names[] =
+{
+#define GAME_SYSTEMS_LIST_X(n, name) name,
+    GAME_SYSTEMS_LIST
+#undef GAME_SYSTEMS_LIST_X
+};
+
+//~ angn: Game
+#define ENTITIES_CAPACITY 4096
+
+// angn: packed copies the motion kernels run on, scratch for game_update
+// apart from the static collider prefix (see below)
+typedef struct EntityMotion EntityMotion;
+struct EntityMotion
+{
+    F32 position_x[ENTITIES_CAPACITY];
+    F32 position_y[ENTITIES_CAPACITY];
+    F32 velocity_x[ENTITIES_CAPACITY];
+    F32 velocity_y[ENTITIES_CAPACITY];
+    F32 scale[ENTITIES_CAPACITY]; // angn: 0 where the flag is off
+
+    //- angn: collisions
+    // angn: NOTE: the first Game::statics_count boxes are the static colliders
+    // and survive between ticks, only the dynamic ones after them are redone
+    U64 colliders_count;
+    Rectangle collider_boxes[ENTITIES_CAPACITY]; // angn: every collider at the start of the tick
+    U64 collider_entities[ENTITIES_CAPACITY];    // angn: entity index of each box
+    F32 sweep_x[ENTITIES_CAPACITY];              // angn: resolved step of each swept entity
+    F32 sweep_y[ENTITIES_CAPACITY];
+};
+
+typedef struct Game Game;
+struct Game
+{
+    Vec2S32 screen;
+    U64 seed; // angn: set before init, replays start from the same one
+    RandomState random; // angn: the only source of randomness the game may use
+
+    Entity entities[ENTITIES_CAPACITY];
+    U64 entities_count;
+
+    SpellInstruction spell_programs[SPELL_PROGRAMS_MAX][SPELL_SLOTS_MAX];
+    SpellType spell_type_rand[3];
+    SpellInstruction spell_instruction_rand[3];
+    _Bool new_spell;
+    SpellData spell_construction;
+
+    SoundEvent sound_events[SOUND_EVENTS_MAX]; // angn: emitted this tick
+    U64 sound_events_count;
+
+    EntityMotion motion; // angn: rebuilt every tick, but the static collider prefix is state, snapshots and reloads have to keep it
+
+    // angn: static colliders are alive colliders without ApplyVelocity, they
+    // never move so their boxes are only rebuilt when one comes or goes
+    B32 statics_dirty;
+    U64 statics_count;
+
+    U64 system_time_us[GameSystem__Count]; // angn: not state, summed over every tick and chunk, for profiling
+
+    // angn: a packed copy of every Entity::flags, what queries scan
+    // angn: NOTE: only change flags with entity_flags_set_in/unset_in so the two agree
+    EntityFlags entity_flags[ENTITIES_CAPACITY];
+};
+
+//~ angn: Entity queries
+// angn: all entities whose flags have every `required` bit and no `excluded`
+// bit, 64 slots of the packed column at a time, then ctz over the matches
+// angn: usage:
+//   for(EntityQuery query = entity_query_make(game, required, excluded);
+//           entity_query_next(&query);)
+//   {
+//       Entity *entity = &game->entities[query.index];
+//   }
+// angn: NOTE: flags changed during the loop are seen by chunks not yet scanned
+typedef struct EntityQuery EntityQuery;
+struct EntityQuery
+{
+    Game *game;
+    U64 required;
+    U64 excluded;
+    U64 chunk_base; // angn: first slot of the next chunk to scan
+    U64 chunk_end;  // angn: one past the last slot to scan
+    U64 matches;    // angn: what is left of the current chunk, bit i is slot chunk_base - 64 + i
+    U64 index;      // angn: the current match
+};
+
+StaticAssert(ENTITIES_CAPACITY % 64 == 0, entities_capacity_chunks);
+StaticAssert(EntityFlagsIndex__Count <= 64, entity_flags_one_word);
+
+internal EntityQuery
+entity_query_make(
+        Game *game,
+        U64 required,
+        U64 excluded)
+{
+    EntityQuery query = { .game = game, .required = required, .excluded = excluded, .chunk_end = ENTITIES_CAPACITY };
+    return(query);
+}
+
+// angn: only slots [first, end), both multiples of 64
+internal EntityQuery
+entity_query_make_range(
+        Game *game,
+        U64 required,
+        U64 excluded,
+        U64 first,
+        U64 end)
+{
+    Assert(first % 64 == 0 && end % 64 == 0 && end <= ENTITIES_CAPACITY);
+    EntityQuery query = { .game = game, .required = required, .excluded = excluded, .chunk_base = first, .chunk_end = end };
+    return(query);
+}
+
+internal B32
+entity_query_next(
+        EntityQuery *query)
+{
+    for(;
+            query->matches == 0 && query->chunk_base < query->chunk_end;
+            query->chunk_base += 64)
+    {
+        EntityFlags *column = &query->game->entity_flags[query->chunk_base];
+        U64 matches = 0;
+        for(U64 i = 0;
+                i < 64;
+                i += 1)
+        {
+            U64 flags = column[i].f[0];
+            U64 match = ((flags & query->required) == query->required) & ((flags & query->excluded) == 0);
+            matches |= match << i;
+        }
+        query->matches = matches;
+    }
+
+    B32 result = query->matches != 0;
+    if(result)
+    {
+        query->index = query->chunk_base - 64 + CountTrailingZerosU64(query->matches);
+        query->matches &= query->matches - 1;
+#if BUILD_DEBUG
+        Assert(query->game->entity_flags[query->index].f[0] == query->game->entities[query->index].flags.f[0]);
+#endif
+    }
+    return(result);
+}
+
+#define ENTITY_STATIC_REQUIRED (EntityFlagsMask(EntityFlagsIndex_Alive) | EntityFlagsMask(EntityFlagsIndex_Collider))
+#define ENTITY_STATIC_EXCLUDED (EntityFlagsMask(EntityFlagsIndex_ApplyVelocity))
+
+internal B32
+entity_flags_is_static(
+        EntityFlags flags)
+{
+    return((flags.f[0] & ENTITY_STATIC_REQUIRED) == ENTITY_STATIC_REQUIRED && (flags.f[0] & ENTITY_STATIC_EXCLUDED) == 0);
+}
+
+internal void
+entity_flags_sync(
+        Game *game,
+        Entity *entity)
+{
+    EntityFlags *column = &game->entity_flags[entity->handle.index];
+    if(entity_flags_is_static(*column) != entity_flags_is_static(entity->flags))
+    {
+        game->statics_dirty = 1;
+    }
+    *column = entity->flags;
+}
+
+internal void
+entity_flags_set_in(
+        Game *game,
+        Entity *entity,
+        EntityFlagsIndex index)
+{
+    entity_flags_set(&entity->flags, index);
+    entity_flags_sync(game, entity);
+}
+
+internal void
+entity_flags_unset_in(
+        Game *game,
+        Entity *entity,
+        EntityFlagsIndex index)
+{
+    entity_flags_unset(&entity->flags, index);
+    entity_flags_sync(game, entity);
+}
+
+internal void
+entity_wake(
+        Game *game,
+        Entity *entity)
+{
+    entity->still_ticks = 0;
+    if(entity_flags_contains(&entity->flags, EntityFlagsIndex_Sleeping))
+    {
+        entity_flags_unset_in(game, entity, EntityFlagsIndex_Sleeping);
+    }
+}
+
+//~ angn: Jobs
+// angn: the platform's worker threads, lent to game_update. the game never
+// makes threads itself (see the hot reload note in orthography_game.c)
+#define GAME_WORKERS_MAX 32
+
+typedef struct GameJobs GameJobs;
+typedef void GameJobProc(void *params, U64 job_index, U64 worker_index);
+typedef void GameJobsRunProc(GameJobs *jobs, GameJobProc *proc, void *params, U64 jobs_count);
+typedef U64 GameNowProc(void);
+
+struct GameJobs
+{
+    GameJobsRunProc *run; // angn: calls proc once per job index across the workers, returns when all are done
+    void *pool;           // angn: the platform's, the game does not look inside
+    U64 workers_count;    // angn: counting the thread that calls run, which is worker 0, 1 runs everything in order
+    GameNowProc *now_microseconds; // angn: the platform's clock, for system timings
+    Arena *scratch[GAME_WORKERS_MAX]; // angn: one per worker, free to use inside a job
+};
+
+//~ angn: Collision stage
+// angn: movers are swept in parallel batches, each writing only its own
+// slots of `results`, then merged on the calling thread in mover order, so
+// any number of workers gives the same bits as one
+#define COLLISION_JOB_MOVERS 64
+
+typedef struct CollisionSweepJob CollisionSweepJob;
+struct CollisionSweepJob
+{
+    Game *game;
+    GameJobs *jobs;
+    F32 dt;
+    CollisionGrid *grid;
+    U32 *movers; // angn: collider index of every awake dynamic collider
+    U64 movers_count;
+    SweepResult *results; // angn: one per mover, contacts already in collider indices
+};
+
+// angn: triggers run the same way, COLLISION_JOB_MOVERS of them per job.
+// a trigger's events go on the worker's scratch arena, which stays pushed
+// until the calling thread has merged every result in trigger order
+typedef struct CollisionTriggerResult CollisionTriggerResult;
+struct CollisionTriggerResult
+{
+    CollisionEvent *events;
+    U64 events_count;
+};
+
+typedef struct CollisionTriggerJob CollisionTriggerJob;
+struct CollisionTriggerJob
+{
+    Game *game;
+    GameJobs *jobs;
+    CollisionGrid *grid; // angn: over every collider's box swept through the step
+    U32 *triggers;       // angn: entity index of every live trigger
+    U64 triggers_count;
+    U8 *seen[GAME_WORKERS_MAX];        // angn: per worker, for collision_grid_query
+    U32 *candidates[GAME_WORKERS_MAX]; // angn: per worker
+    CollisionTriggerResult *results;   // angn: one per trigger
+};
+
+//~ angn: Systems
+// angn: game_update is a list of systems, each saying which parts of the
+// game it reads and writes. the scheduler runs neighbours that do not
+// touch each other's writes at the same time, and a Chunked system's
+// entity slots in GAME_SYSTEM_CHUNK_ENTITIES pieces on different workers
+// angn: NOTE: a Chunked system must only touch the entities in its range
+// (and their slots of EntityMotion), everything else goes in Single. with
+// one worker every job runs in list order, which is the reference result
+#define GAME_SYSTEM_CHUNK_ENTITIES 512
+
+StaticAssert(ENTITIES_CAPACITY % GAME_SYSTEM_CHUNK_ENTITIES == 0, game_system_chunks);
+StaticAssert(GAME_SYSTEM_CHUNK_ENTITIES % 64 == 0, game_system_chunk_queries);
+
+typedef enum : U64
+{
+    GameComponent_Transform   = (1 << 0), // angn: position, prev_position, spell rotations
+    GameComponent_Velocity    = (1 << 1),
+    GameComponent_Animation   = (1 << 2), // angn: player_state, animations
+    GameComponent_Spell       = (1 << 3), // angn: spell_data apart from rotations
+    GameComponent_Flags       = (1 << 4), // angn: flags, the flags column, still_ticks
+    GameComponent_Motion      = (1 << 5), // angn: Game::motion
+    GameComponent_Events      = (1 << 6), // angn: sound and collision events
+    GameComponent_SpellEditor = (1 << 7), // angn: spell_construction, spell_programs, the rolls, random
+    GameComponent_All         = ~0ull,    // angn: allocates or destroys entities
+} GameComponent;
+
+typedef enum : U8
+{
+    GameSystemMode_Single,    // angn: one job
+    GameSystemMode_Chunked,   // angn: one job per chunk of entity slots
+    GameSystemMode_Exclusive, // angn: alone, on the calling thread, free to use GameJobs itself
+} GameSystemMode;
+
+typedef struct GameSystemContext GameSystemContext;
+struct GameSystemContext
+{
+    GameJobs *jobs;
+    InputState *inputs;
+    F32 dt;
+    CollisionEvent *collision_events; // angn: this tick's, COLLISIONS_MAX of them on jobs->scratch[0]
+    U64 collision_events_count;
+    U64 collision_events_dropped;     // angn: over COLLISIONS_MAX
+};
+
+typedef void GameSystemProc(Game *game, GameSystemContext *context, U64 first, U64 end);
+
+typedef struct GameSystem GameSystem;
+struct GameSystem
+{
+    GameSystemProc *run;
+    GameSystemMode mode;
+    U64 reads;  // angn: GameComponent
+    U64 writes; // angn: GameComponent
+};
+
+typedef struct GameSystemBatch GameSystemBatch;
+struct GameSystemBatch
+{
+    Game *game;
+    GameSystemContext *context;
+    U64 first_system;
+    U64 end_system;
+    U64 job_starts[GameSystem__Count + 1]; // angn: jobs of system s are [job_starts[s - first], job_starts[s - first + 1])
+};
+
+//~ angn: Game API
+// angn: everything the platform layer calls into the game through, so the game
+// can live in a shared library and be swapped out while `Game` stays put
+// angn: NOTE: bump this whenever `Game` or the table changes shape, a library
+// with a different version is never loaded over live state
+#define GAME_API_VERSION 13
+#define GAME_API_PROC_NAME "game_get_api"
+
+// angn: what a tick leaves besides `Game`, for tools that want to look at it.
+// the tick's own buffers are gone once update returns, so it is copied onto `arena`
+typedef struct GameTickOutput GameTickOutput;
+struct GameTickOutput
+{
+    Arena *arena;
+    CollisionEvent *collision_events;
+    U64 collision_events_count;
+};
+
+typedef void GameLoadProc(OS_SystemInfo *system_info); // angn: every time the code is (re)loaded, before init or update
+typedef void GameInitProc(Game *game, Arena *arena);
+typedef void GameUpdateProc(Game *game, GameJobs *jobs, Inputs inputs, F32 dt, GameTickOutput *output); // angn: output is optional
+
+typedef struct GameApi GameApi;
+struct GameApi
+{
+    U64 version;
+    U64 game_size;
+    GameLoadProc *load;
+    GameInitProc *init;
+    GameUpdateProc *update;
+};
+
+typedef GameApi GameGetApiProc(void);
+
+#endif // ORTHOGRAPHY_GAME_H
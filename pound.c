@@ -100,6 +100,18 @@ Sources:
     #define ARCH_32BIT 1
 #endif
 
+// ENVIRONMENT: simd
+// angn: chosen at compile time, SSE2 is part of x64 so it is always there,
+// AVX2 needs -mavx2 (/arch:AVX2 on msvc)
+#if ARCH_X64
+    #define SIMD_SSE2 1
+    #if defined(__AVX2__)
+        #define SIMD_AVX2 1
+    #endif
+#elif ARCH_ARM64
+    #define SIMD_NEON 1
+#endif
+
 /* CORE */
 #if OS_LINUX
 #define _GNU_SOURCE 1 // angn: NOTE: not sure if this works on all linux systems
@@ -107,8 +119,18 @@ Sources:
 #endif
 
 #include <stdint.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+
+#if SIMD_AVX2
+    #include <immintrin.h>
+#elif SIMD_SSE2
+    #include <emmintrin.h>
+#elif SIMD_NEON
+    #include <arm_neon.h>
+#endif
 
 // CORE: keywords
 // angn: stolen from Casey Muratori
@@ -134,6 +156,14 @@ Sources:
     #error force_inline undefined
 #endif
 
+#if COMPILER_MSVC
+    #define exported __declspec(dllexport)
+#elif COMPILER_CLANG || COMPILER_GCC
+    #define exported __attribute__((visibility("default")))
+#else
+    #error exported undefined
+#endif
+
 #if COMPILER_MSVC
     #define no_inline __declspec(noinline)
 #elif COMPILER_CLANG || COMPILER_GCC
@@ -274,7 +304,34 @@ typedef void VoidProc(void);
     #define NotUsed(x) (void)0
 #endif
 
-// angn: TODO: CORE: atomics
+// CORE: atomics
+// angn: NOTE: loads acquire, stores release, read-modify-writes are full barriers
+#if COMPILER_MSVC
+    #include <intrin.h>
+    #define AtomicLoadU64(x) ((U64)_InterlockedOr64((volatile __int64 *)(x), 0))
+    #define AtomicStoreU64(x,v) ((void)_InterlockedExchange64((volatile __int64 *)(x), (__int64)(v)))
+    #define AtomicExchangeU64(x,v) ((U64)_InterlockedExchange64((volatile __int64 *)(x), (__int64)(v)))
+    #define AtomicAddU64(x,v) ((U64)_InterlockedExchangeAdd64((volatile __int64 *)(x), (__int64)(v)) + (U64)(v))
+    #define AtomicCompareExchangeU64(x,c,v) ((U64)_InterlockedCompareExchange64((volatile __int64 *)(x), (__int64)(v), (__int64)(c)))
+#elif COMPILER_CLANG || COMPILER_GCC
+    #define AtomicLoadU64(x) __atomic_load_n((x), __ATOMIC_ACQUIRE)
+    #define AtomicStoreU64(x,v) __atomic_store_n((x), (v), __ATOMIC_RELEASE)
+    #define AtomicExchangeU64(x,v) __atomic_exchange_n((x), (v), __ATOMIC_ACQ_REL)
+    #define AtomicAddU64(x,v) __atomic_add_fetch((x), (v), __ATOMIC_ACQ_REL)
+    #define AtomicCompareExchangeU64(x,c,v) __sync_val_compare_and_swap((x), (c), (v)) // returns the old value
+#else
+    #error atomics undefined
+#endif
+
+// CORE: bits
+// angn: x must not be 0
+#if COMPILER_MSVC
+    #define CountTrailingZerosU64(x) ((U64)_tzcnt_u64(x))
+#elif COMPILER_CLANG || COMPILER_GCC
+    #define CountTrailingZerosU64(x) ((U64)__builtin_ctzll(x))
+#else
+    #error CountTrailingZerosU64 undefined
+#endif
 
 // CORE: linked lists
 // angn: TODO: add more helpers
@@ -283,8 +340,6 @@ typedef void VoidProc(void);
 #define SLLStackPush_N(s,n,next) ((n)->next=(s), (s)=(n))
 #define SLLStackPop_N(s,next) ((s)=(s)->next)
 
-// angn: TODO: CORE: generic string hashing function
-
 /* PROTO Math */
 // PROTO Math: vector
 typedef union Vec2F32 Vec2F32;
@@ -509,6 +564,315 @@ union Range2F32
     Vec2F32 v[2];
 };
 
+// PROTO Math: vector operations
+internal Vec2F32
+vec2f32_make(
+        F32 x,
+        F32 y);
+
+internal Vec2F32
+vec2f32_add(
+        Vec2F32 a,
+        Vec2F32 b);
+
+internal Vec2F32
+vec2f32_sub(
+        Vec2F32 a,
+        Vec2F32 b);
+
+internal Vec2F32
+vec2f32_mul(
+        Vec2F32 a,
+        Vec2F32 b);
+
+internal Vec2F32
+vec2f32_scale(
+        Vec2F32 a,
+        F32 s);
+
+internal F32
+vec2f32_dot(
+        Vec2F32 a,
+        Vec2F32 b);
+
+internal F32
+vec2f32_length(
+        Vec2F32 a);
+
+// angn: zero stays zero
+internal Vec2F32
+vec2f32_normalize(
+        Vec2F32 a);
+
+// radians, counter clockwise in y-up
+internal Vec2F32
+vec2f32_rotate(
+        Vec2F32 a,
+        F32 angle);
+
+internal Vec2F32
+vec2f32_lerp(
+        Vec2F32 a,
+        Vec2F32 b,
+        F32 t);
+
+internal Vec3F32
+vec3f32_make(
+        F32 x,
+        F32 y,
+        F32 z);
+
+internal Vec3F32
+vec3f32_add(
+        Vec3F32 a,
+        Vec3F32 b);
+
+internal Vec3F32
+vec3f32_sub(
+        Vec3F32 a,
+        Vec3F32 b);
+
+internal Vec3F32
+vec3f32_scale(
+        Vec3F32 a,
+        F32 s);
+
+internal F32
+vec3f32_dot(
+        Vec3F32 a,
+        Vec3F32 b);
+
+internal Vec3F32
+vec3f32_cross(
+        Vec3F32 a,
+        Vec3F32 b);
+
+internal F32
+vec3f32_length(
+        Vec3F32 a);
+
+internal Vec3F32
+vec3f32_normalize(
+        Vec3F32 a);
+
+internal Vec4F32
+vec4f32_make(
+        F32 x,
+        F32 y,
+        F32 z,
+        F32 w);
+
+internal Vec4F32
+vec4f32_add(
+        Vec4F32 a,
+        Vec4F32 b);
+
+internal Vec4F32
+vec4f32_sub(
+        Vec4F32 a,
+        Vec4F32 b);
+
+internal Vec4F32
+vec4f32_mul(
+        Vec4F32 a,
+        Vec4F32 b);
+
+internal Vec4F32
+vec4f32_scale(
+        Vec4F32 a,
+        F32 s);
+
+internal F32
+vec4f32_dot(
+        Vec4F32 a,
+        Vec4F32 b);
+
+internal F32
+vec4f32_length(
+        Vec4F32 a);
+
+// PROTO Math: matrix operations
+// angn: row major, v[row][column], vectors are columns: M * v
+internal Mat3x3F32
+mat3x3f32_identity(void);
+
+internal Mat3x3F32
+mat3x3f32_mul(
+        Mat3x3F32 a,
+        Mat3x3F32 b);
+
+internal Vec3F32
+mat3x3f32_mul_vec3f32(
+        Mat3x3F32 m,
+        Vec3F32 v);
+
+// angn: 2D affine
+internal Mat3x3F32
+mat3x3f32_translate(
+        Vec2F32 delta);
+
+internal Mat3x3F32
+mat3x3f32_rotate(
+        F32 angle);
+
+internal Mat3x3F32
+mat3x3f32_scale(
+        Vec2F32 scale);
+
+internal Mat4x4F32
+mat4x4f32_identity(void);
+
+internal Mat4x4F32
+mat4x4f32_mul(
+        Mat4x4F32 a,
+        Mat4x4F32 b);
+
+internal Vec4F32
+mat4x4f32_mul_vec4f32(
+        Mat4x4F32 m,
+        Vec4F32 v);
+
+internal Mat4x4F32
+mat4x4f32_translate(
+        Vec3F32 delta);
+
+internal Mat4x4F32
+mat4x4f32_scale(
+        Vec3F32 scale);
+
+internal Mat4x4F32
+mat4x4f32_rotate_z(
+        F32 angle);
+
+internal Mat4x4F32
+mat4x4f32_transpose(
+        Mat4x4F32 m);
+
+// PROTO Math: range operations
+// angn: sorts the ends
+internal Range1F32
+range1f32_make(
+        F32 min,
+        F32 max);
+
+internal F32
+range1f32_dim(
+        Range1F32 r);
+
+// angn: [min, max)
+internal B32
+range1f32_contains(
+        Range1F32 r,
+        F32 x);
+
+internal B32
+range1f32_overlaps(
+        Range1F32 a,
+        Range1F32 b);
+
+internal Range1U64
+range1u64_make(
+        U64 min,
+        U64 max);
+
+internal U64
+range1u64_dim(
+        Range1U64 r);
+
+internal Range2F32
+range2f32_make(
+        Vec2F32 min,
+        Vec2F32 max);
+
+internal Range2F32
+range2f32_from_rect(
+        F32 x,
+        F32 y,
+        F32 width,
+        F32 height);
+
+internal Vec2F32
+range2f32_dim(
+        Range2F32 r);
+
+internal Vec2F32
+range2f32_center(
+        Range2F32 r);
+
+internal Range2F32
+range2f32_pad(
+        Range2F32 r,
+        F32 pad);
+
+internal Range2F32
+range2f32_shift(
+        Range2F32 r,
+        Vec2F32 delta);
+
+internal Range2F32
+range2f32_union(
+        Range2F32 a,
+        Range2F32 b);
+
+// angn: [min, max)
+internal B32
+range2f32_contains(
+        Range2F32 r,
+        Vec2F32 p);
+
+// angn: touching edges do not overlap
+internal B32
+range2f32_overlaps(
+        Range2F32 a,
+        Range2F32 b);
+
+internal Range2S32
+range2s32_make(
+        Vec2S32 min,
+        Vec2S32 max);
+
+internal Vec2S32
+range2s32_dim(
+        Range2S32 r);
+
+// PROTO Math: batch kernels
+// angn: over arrays, `out` may alias an input. SSE2/AVX2/NEON picked at compile time
+internal void
+vec2f32_add_batch(
+        Vec2F32 *out,
+        Vec2F32 *a,
+        Vec2F32 *b,
+        U64 count);
+
+internal void
+vec2f32_scale_batch(
+        Vec2F32 *out,
+        Vec2F32 *a,
+        F32 s,
+        U64 count);
+
+internal void
+vec2f32_rotate_batch(
+        Vec2F32 *out,
+        Vec2F32 *a,
+        F32 angle,
+        U64 count);
+
+// angn: a[i] against b[i]
+internal void
+range2f32_overlaps_batch(
+        B8 *out,
+        Range2F32 *a,
+        Range2F32 *b,
+        U64 count);
+
+internal void
+mat4x4f32_transform_batch(
+        Vec4F32 *out,
+        Mat4x4F32 m,
+        Vec4F32 *in,
+        U64 count);
+
 /* PROTO String */
 typedef struct String8 String8;
 struct String8
@@ -517,6 +881,9 @@ struct String8
     U64 size;
 };
 
+// angn: e.g. String8Lit("audio"), string literals only
+#define String8Lit(s) ((String8){ .string = (U8 *)(s), .size = sizeof(s) - 1 })
+
 internal String8
 string8_make(
         U8 *str,
@@ -535,11 +902,109 @@ internal String8
 string8_make_zero(
         void);
 
+// angn: the bytes in [range.min, range.max), clamped to the string
 internal String8
 string8_slice(
         String8 str,
         Range1U64 range);
 
+internal String8
+string8_prefix(
+        String8 str,
+        U64 size);
+
+internal String8
+string8_skip(
+        String8 str,
+        U64 size);
+
+internal String8
+string8_chop(
+        String8 str,
+        U64 size);
+
+// PROTO String: comparison
+internal B32
+string8_match(
+        String8 a,
+        String8 b);
+
+// angn: byte order, <0, 0 or >0 like memcmp, a prefix sorts first
+internal S32
+string8_compare(
+        String8 a,
+        String8 b);
+
+internal B32
+string8_starts_with(
+        String8 str,
+        String8 prefix);
+
+internal B32
+string8_ends_with(
+        String8 str,
+        String8 suffix);
+
+// angn: index of the first needle at or after start, str.size when there is none
+internal U64
+string8_find(
+        String8 str,
+        String8 needle,
+        U64 start);
+
+/* PROTO Random */
+// angn: PCG32, 16 bytes of state, same sequence on every platform for a seed
+// angn: NOTE: not thread safe, give each thread its own stream with random_split
+typedef struct RandomState RandomState;
+struct RandomState
+{
+    U64 state;
+    U64 increment; // angn: selects the stream, always odd
+};
+
+internal RandomState
+random_make(
+        U64 seed,
+        U64 stream);
+
+// angn: an independent stream seeded from `parent`, for handing to workers
+internal RandomState
+random_split(
+        RandomState *parent,
+        U64 stream);
+
+internal U32
+random_u32(
+        RandomState *random);
+
+internal U64
+random_u64(
+        RandomState *random);
+
+// angn: [0, bound) without modulo bias
+internal U32
+random_u32_bounded(
+        RandomState *random,
+        U32 bound);
+
+// angn: [0, 1)
+internal F32
+random_f32(
+        RandomState *random);
+
+internal void
+random_fill_u32(
+        RandomState *random,
+        U32 *out,
+        U64 count);
+
+internal void
+random_fill_u32_bounded(
+        RandomState *random,
+        U32 *out,
+        U64 count,
+        U32 bound);
+
 /* PROTO Arena */
 #define ARENA_HEADER_SIZE 128
 
@@ -647,6 +1112,218 @@ temp_arena_end(
 
 #define arena_pop_array(a,t,n) arena_pop(a, sizeof(t) * (n))
 
+/* PROTO Hash */
+// angn: wyhash, fast and well mixed but not cryptographic, do not feed it
+// anything an attacker picks and expects to stay balanced
+#define HASH_SEED_DEFAULT 0x9e3779b97f4a7c15ull
+
+internal U64
+hash_u64_from_bytes(
+        void *data,
+        U64 size,
+        U64 seed);
+
+internal U64
+hash_u64(
+        U64 x);
+
+internal U64
+string8_hash(
+        String8 str);
+
+// PROTO Hash: map
+// angn: open addressing, swiss table layout: one control byte per slot holds
+// 7 bits of the hash, a group of 16 of them is compared against the probe in
+// one SIMD compare, so most lookups touch one key
+// angn: NOTE: arena backed, growing leaves the old arrays behind in the arena,
+// hash_map_reserve up front when the size is known
+#define HASH_MAP_GROUP_SIZE 16
+#define HASH_MAP_CONTROL_EMPTY   0x80
+#define HASH_MAP_CONTROL_DELETED 0xfe
+
+typedef enum : U8
+{
+    HashMapKeyKind_Bytes,   // angn: key_size plain bytes, compared with memcmp
+    HashMapKeyKind_String8, // angn: the key is a String8, hashed and compared by content, the bytes are not copied
+} HashMapKeyKind;
+
+typedef struct HashMap HashMap;
+struct HashMap
+{
+    Arena *arena;
+    U8 *control;   // angn: capacity bytes, empty, deleted or the low 7 bits of the hash
+    U8 *slots;     // angn: capacity slots of key then value
+    U64 capacity;  // angn: power of two, a multiple of the group size
+    U64 count;
+    U64 deleted_count;
+    U64 key_size;
+    U64 value_size;
+    U64 value_offset;
+    U64 slot_size;
+    HashMapKeyKind key_kind;
+};
+
+typedef struct HashMapIterator HashMapIterator;
+struct HashMapIterator
+{
+    HashMap *map;
+    U64 index;
+    void *key;
+    void *value;
+};
+
+internal HashMap
+hash_map_make(
+        Arena *arena,
+        HashMapKeyKind key_kind,
+        U64 key_size,
+        U64 value_size,
+        U64 capacity); // angn: entries it holds before growing, can be 0
+
+// angn: the value for key, 0 when it is not there
+internal void *
+hash_map_lookup(
+        HashMap *map,
+        void *key);
+
+// angn: the value for key, added zeroed if it was not there
+internal void *
+hash_map_insert(
+        HashMap *map,
+        void *key,
+        B32 *found); // angn: optional
+
+internal B32
+hash_map_remove(
+        HashMap *map,
+        void *key);
+
+internal void
+hash_map_reserve(
+        HashMap *map,
+        U64 count);
+
+internal void
+hash_map_clear(
+        HashMap *map);
+
+// angn: e.g. for(HashMapIterator it = hash_map_iterator_make(map); hash_map_iterator_next(&it);)
+internal HashMapIterator
+hash_map_iterator_make(
+        HashMap *map);
+
+internal B32
+hash_map_iterator_next(
+        HashMapIterator *iterator);
+
+// angn: typed wrappers, HashMapDefine(asset_ids, String8, U32) gives
+// asset_ids_make, asset_ids_lookup, asset_ids_insert and asset_ids_remove
+#define HashMapDefine_(name,K,V,kind) \
+    internal HashMap name##_make(Arena *arena, U64 capacity) { return(hash_map_make(arena, (kind), sizeof(K), sizeof(V), capacity)); } \
+    internal V *name##_lookup(HashMap *map, K key) { return((V *)hash_map_lookup(map, &key)); } \
+    internal V *name##_insert(HashMap *map, K key, B32 *found) { return((V *)hash_map_insert(map, &key, found)); } \
+    internal B32 name##_remove(HashMap *map, K key) { return(hash_map_remove(map, &key)); }
+#define HashMapDefine(name,K,V) HashMapDefine_(name, K, V, HashMapKeyKind_Bytes)
+#define HashMapDefineString8(name,V) HashMapDefine_(name, String8, V, HashMapKeyKind_String8)
+
+/* PROTO String: building */
+// angn: every string pushed here is null terminated past its size, so it
+// can go straight to C APIs
+typedef struct String8Node String8Node;
+struct String8Node
+{
+    String8Node *next;
+    String8 string;
+};
+
+// angn: pieces that are only copied together when joined
+typedef struct String8List String8List;
+struct String8List
+{
+    String8Node *first;
+    String8Node *last;
+    U64 node_count;
+    U64 total_size;
+};
+
+internal String8
+string8_push_copy(
+        Arena *arena,
+        String8 str);
+
+internal String8
+string8_push_concat(
+        Arena *arena,
+        String8 a,
+        String8 b);
+
+internal String8
+string8_push_fmtv(
+        Arena *arena,
+        char *fmt,
+        va_list args);
+
+internal String8
+string8_push_fmt(
+        Arena *arena,
+        char *fmt,
+        ...);
+
+// angn: the node points at str, the bytes are not copied
+internal void
+string8_list_push(
+        Arena *arena,
+        String8List *list,
+        String8 str);
+
+internal void
+string8_list_push_fmt(
+        Arena *arena,
+        String8List *list,
+        char *fmt,
+        ...);
+
+internal String8
+string8_list_join(
+        Arena *arena,
+        String8List *list,
+        String8 separator);
+
+/* PROTO String: interning */
+// angn: one stable U32 id per distinct string, 0 is never handed out. the
+// bytes are copied once and never move, so interned strings can be kept
+// NOTE: not thread safe, interning while others look up needs a lock
+typedef struct String8InternTable String8InternTable;
+struct String8InternTable
+{
+    Arena *arena;
+    HashMap ids;      // angn: String8 -> U32
+    String8 *strings; // angn: by id
+    U64 count;        // angn: ids handed out, plus the unused 0
+    U64 capacity;
+};
+
+internal String8InternTable
+string8_intern_table_make(
+        Arena *arena,
+        U64 capacity);
+
+internal U32
+string8_intern(
+        String8InternTable *table,
+        String8 str);
+
+// angn: 0 when str was never interned
+internal U32
+string8_intern_lookup(
+        String8InternTable *table,
+        String8 str);
+
+internal String8
+string8_from_intern_id(
+        String8InternTable *table,
+        U32 id);
+
 /* PROTO OS */
 // PROTO OS: system info
 typedef struct OS_SystemInfo OS_SystemInfo;
@@ -694,12 +1371,212 @@ os_decommit(
         void *ptr,
         U64 size);
 
+// PROTO OS: handle
+typedef struct OS_Handle OS_Handle;
+struct OS_Handle
+{
+    U64 u64[1];
+};
+
+// PROTO OS: threads
+typedef void OS_ThreadFunction(void *params);
+
+// angn: NOTE: only launch threads from the main thread, the launch state
+// lives in the OS arena
+internal OS_Handle
+os_thread_launch(
+        OS_ThreadFunction *func,
+        void *params);
+
+internal void
+os_thread_join(
+        OS_Handle thread);
+
+// PROTO OS: semaphores
+// angn: NOTE: like threads, only allocate semaphores from the main thread
+internal OS_Handle
+os_semaphore_alloc(
+        U32 initial_count);
+
+internal void
+os_semaphore_release(
+        OS_Handle semaphore);
+
+internal void
+os_semaphore_signal(
+        OS_Handle semaphore,
+        U32 count);
+
+internal void
+os_semaphore_wait(
+        OS_Handle semaphore);
+
+// PROTO OS: time
+internal U64
+os_now_microseconds(
+        void);
+
+internal void
+os_sleep_milliseconds(
+        U32 msec);
+
+// PROTO OS: files
+#define OS_PATH_MAX 4096
+
+typedef U32 OS_AccessFlags;
+enum
+{
+    OS_AccessFlag_Read = (1<<0),
+    OS_AccessFlag_Write = (1<<1), // angn: creates, truncates unless also Read
+};
+
+// angn: NOTE: a zeroed handle is an invalid file
+internal OS_Handle
+os_file_open(
+        OS_AccessFlags flags,
+        String8 path);
+
+internal void
+os_file_close(
+        OS_Handle file);
+
+internal U64
+os_file_size(
+        OS_Handle file);
+
+// angn: returns the number of bytes actually read/written
+internal U64
+os_file_read(
+        OS_Handle file,
+        U64 offset,
+        void *out,
+        U64 size);
+
+internal U64
+os_file_write(
+        OS_Handle file,
+        U64 offset,
+        void *data,
+        U64 size);
+
+// angn: 0 if the file does not exist, only good for comparing against itself
+internal U64
+os_file_modified_time(
+        String8 path);
+
+internal B32
+os_file_delete(
+        String8 path);
+
+// angn: the whole file, null terminated for convenience, empty on failure
+internal String8
+os_data_from_file_path(
+        Arena *arena,
+        String8 path);
+
+internal B32
+os_write_data_to_file_path(
+        String8 path,
+        String8 data);
+
+// PROTO OS: file mapping
+
+typedef struct OS_FileMap OS_FileMap;
+struct OS_FileMap
+{
+    void *base; // angn: 0 if the file could not be mapped
+    U64 size;
+};
+
+// angn: NOTE: read-only, the view stays valid until unmapped even though the
+// file itself is closed
+internal OS_FileMap
+os_file_map(
+        String8 path);
+
+internal void
+os_file_unmap(
+        OS_FileMap map);
+
+// PROTO OS: file watching
+#define OS_FILE_WATCH_DIRECTORIES_MAX 16
+
+typedef struct OS_FileWatchEvent OS_FileWatchEvent;
+struct OS_FileWatchEvent
+{
+    OS_FileWatchEvent *next;
+    String8 path; // angn: watched directory + "/" + file name
+};
+
+typedef struct OS_FileWatchEventList OS_FileWatchEventList;
+struct OS_FileWatchEventList
+{
+    OS_FileWatchEvent *first;
+    U64 count;
+};
+
+// angn: NOTE: reports files that finished being written or were moved into a
+// watched directory (not recursive). open/add from the main thread, wait from any
+internal OS_Handle
+os_file_watch_open(
+        void);
+
+internal B32
+os_file_watch_add_directory(
+        OS_Handle watch,
+        String8 path);
+
+internal OS_FileWatchEventList
+os_file_watch_wait(
+        Arena *arena,
+        OS_Handle watch,
+        U32 timeout_msec);
+
+// PROTO OS: dynamic libraries
+internal OS_Handle
+os_library_open(
+        String8 path);
+
+internal VoidProc *
+os_library_load_proc(
+        OS_Handle library,
+        char *name);
+
+internal void
+os_library_close(
+        OS_Handle library);
+
 // PROTO OS: linux
 #if OS_LINUX
 
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/sysinfo.h>
+#include <sys/inotify.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <dlfcn.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+typedef struct OS_Linux_Thread OS_Linux_Thread;
+struct OS_Linux_Thread
+{
+    pthread_t handle;
+    OS_ThreadFunction *func;
+    void *params;
+};
+
+typedef struct OS_Linux_FileWatch OS_Linux_FileWatch;
+struct OS_Linux_FileWatch
+{
+    int fd;
+    U32 directories_count;
+    int wds[OS_FILE_WATCH_DIRECTORIES_MAX];
+    String8 directories[OS_FILE_WATCH_DIRECTORIES_MAX];
+};
 
 typedef struct OS_Linux_State OS_Linux_State;
 struct OS_Linux_State
@@ -788,11 +1665,20 @@ typedef struct tagBITMAPINFOHEADER {
     #include "propidl.h"
 #endif
 
+typedef struct OS_Win32_Thread OS_Win32_Thread;
+struct OS_Win32_Thread
+{
+    HANDLE handle;
+    OS_ThreadFunction *func;
+    void *params;
+};
+
 typedef struct OS_Win32_State OS_Win32_State;
 struct OS_Win32_State
 {
     Arena *arena;
     OS_SystemInfo system_info;
+    U64 microsecond_resolution;
 };
 
 global OS_Win32_State g_os_win32_state;
@@ -804,72 +1690,1843 @@ OS_SystemInfo *os_get_system_info(void) { return(&g_os_win32_state.system_info);
 
 #endif // POUNDC_H
 
+/* IMPL MATH */
+#if IMPL_POUNDC_MATH
+#undef IMPL_POUNDC_MATH
 
+// IMPL Math: vector operations
+internal Vec2F32
+vec2f32_make(
+        F32 x,
+        F32 y)
+{
+    return((Vec2F32){ .x = x, .y = y });
+}
 
+internal Vec2F32
+vec2f32_add(
+        Vec2F32 a,
+        Vec2F32 b)
+{
+    return(vec2f32_make(a.x + b.x, a.y + b.y));
+}
 
+internal Vec2F32
+vec2f32_sub(
+        Vec2F32 a,
+        Vec2F32 b)
+{
+    return(vec2f32_make(a.x - b.x, a.y - b.y));
+}
 
-/* IMPL STRING */
-#if IMPL_POUNDC_STRING
-#undef IMPL_POUNDC_STRING
+internal Vec2F32
+vec2f32_mul(
+        Vec2F32 a,
+        Vec2F32 b)
+{
+    return(vec2f32_make(a.x * b.x, a.y * b.y));
+}
 
-internal String8
-string8_make(
-        U8 *str,
-        U64 size)
+internal Vec2F32
+vec2f32_scale(
+        Vec2F32 a,
+        F32 s)
 {
-    return((String8)
-            {
-                .string = str,
-                .size = size,
-            });
+    return(vec2f32_make(a.x * s, a.y * s));
 }
 
-internal String8
-string8_from_cstring(
-        char *cstr)
+internal F32
+vec2f32_dot(
+        Vec2F32 a,
+        Vec2F32 b)
 {
-    return((String8)
-            {
-                .string = (U8 *)cstr,
-                .size = (U64)strlen(cstr),
-            });
+    return(a.x * b.x + a.y * b.y);
 }
 
-internal String8
-string8_from_range(
-        U8 *first,
-        U8 *one_past_last)
+internal F32
+vec2f32_length(
+        Vec2F32 a)
 {
-    return((String8)
+    return(sqrtf(vec2f32_dot(a, a)));
+}
+
+internal Vec2F32
+vec2f32_normalize(
+        Vec2F32 a)
+{
+    F32 length = vec2f32_length(a);
+    return(length > 0.0f ? vec2f32_scale(a, 1.0f / length) : a);
+}
+
+internal Vec2F32
+vec2f32_rotate(
+        Vec2F32 a,
+        F32 angle)
+{
+    F32 c = cosf(angle);
+    F32 s = sinf(angle);
+    return(vec2f32_make(a.x * c - a.y * s, a.x * s + a.y * c));
+}
+
+internal Vec2F32
+vec2f32_lerp(
+        Vec2F32 a,
+        Vec2F32 b,
+        F32 t)
+{
+    return(vec2f32_make(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t));
+}
+
+internal Vec3F32
+vec3f32_make(
+        F32 x,
+        F32 y,
+        F32 z)
+{
+    return((Vec3F32){ .x = x, .y = y, .z = z });
+}
+
+internal Vec3F32
+vec3f32_add(
+        Vec3F32 a,
+        Vec3F32 b)
+{
+    return(vec3f32_make(a.x + b.x, a.y + b.y, a.z + b.z));
+}
+
+internal Vec3F32
+vec3f32_sub(
+        Vec3F32 a,
+        Vec3F32 b)
+{
+    return(vec3f32_make(a.x - b.x, a.y - b.y, a.z - b.z));
+}
+
+internal Vec3F32
+vec3f32_scale(
+        Vec3F32 a,
+        F32 s)
+{
+    return(vec3f32_make(a.x * s, a.y * s, a.z * s));
+}
+
+internal F32
+vec3f32_dot(
+        Vec3F32 a,
+        Vec3F32 b)
+{
+    return(a.x * b.x + a.y * b.y + a.z * b.z);
+}
+
+internal F32
+vec3f32_length(
+        Vec3F32 a)
+{
+    return(sqrtf(vec3f32_dot(a, a)));
+}
+
+internal Vec3F32
+vec3f32_cross(
+        Vec3F32 a,
+        Vec3F32 b)
+{
+    return(vec3f32_make(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x));
+}
+
+internal Vec3F32
+vec3f32_normalize(
+        Vec3F32 a)
+{
+    F32 length = vec3f32_length(a);
+    return(length > 0.0f ? vec3f32_scale(a, 1.0f / length) : a);
+}
+
+internal Vec4F32
+vec4f32_make(
+        F32 x,
+        F32 y,
+        F32 z,
+        F32 w)
+{
+    return((Vec4F32){ .x = x, .y = y, .z = z, .w = w });
+}
+
+internal Vec4F32
+vec4f32_add(
+        Vec4F32 a,
+        Vec4F32 b)
+{
+    return(vec4f32_make(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w));
+}
+
+internal Vec4F32
+vec4f32_sub(
+        Vec4F32 a,
+        Vec4F32 b)
+{
+    return(vec4f32_make(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w));
+}
+
+internal Vec4F32
+vec4f32_mul(
+        Vec4F32 a,
+        Vec4F32 b)
+{
+    return(vec4f32_make(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w));
+}
+
+internal Vec4F32
+vec4f32_scale(
+        Vec4F32 a,
+        F32 s)
+{
+    return(vec4f32_make(a.x * s, a.y * s, a.z * s, a.w * s));
+}
+
+internal F32
+vec4f32_dot(
+        Vec4F32 a,
+        Vec4F32 b)
+{
+    return(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+}
+
+internal F32
+vec4f32_length(
+        Vec4F32 a)
+{
+    return(sqrtf(vec4f32_dot(a, a)));
+}
+
+// IMPL Math: matrix operations
+internal Mat3x3F32
+mat3x3f32_identity(void)
+{
+    Mat3x3F32 m = {0};
+    for(U64 i = 0;
+            i < 3;
+            i += 1)
+    {
+        m.v[i][i] = 1.0f;
+    }
+    return(m);
+}
+
+internal Mat3x3F32
+mat3x3f32_mul(
+        Mat3x3F32 a,
+        Mat3x3F32 b)
+{
+    Mat3x3F32 m = {0};
+    for(U64 r = 0;
+            r < 3;
+            r += 1)
+    {
+        for(U64 c = 0;
+                c < 3;
+                c += 1)
+        {
+            m.v[r][c] = a.v[r][0] * b.v[0][c] + a.v[r][1] * b.v[1][c] + a.v[r][2] * b.v[2][c];
+        }
+    }
+    return(m);
+}
+
+internal Vec3F32
+mat3x3f32_mul_vec3f32(
+        Mat3x3F32 m,
+        Vec3F32 v)
+{
+    Vec3F32 result = {0};
+    for(U64 r = 0;
+            r < 3;
+            r += 1)
+    {
+        result.v[r] = m.v[r][0] * v.x + m.v[r][1] * v.y + m.v[r][2] * v.z;
+    }
+    return(result);
+}
+
+internal Mat3x3F32
+mat3x3f32_translate(
+        Vec2F32 delta)
+{
+    Mat3x3F32 m = mat3x3f32_identity();
+    m.v[0][2] = delta.x;
+    m.v[1][2] = delta.y;
+    return(m);
+}
+
+internal Mat3x3F32
+mat3x3f32_rotate(
+        F32 angle)
+{
+    F32 c = cosf(angle);
+    F32 s = sinf(angle);
+    Mat3x3F32 m = mat3x3f32_identity();
+    m.v[0][0] = c;
+    m.v[0][1] = -s;
+    m.v[1][0] = s;
+    m.v[1][1] = c;
+    return(m);
+}
+
+internal Mat3x3F32
+mat3x3f32_scale(
+        Vec2F32 scale)
+{
+    Mat3x3F32 m = mat3x3f32_identity();
+    m.v[0][0] = scale.x;
+    m.v[1][1] = scale.y;
+    return(m);
+}
+
+internal Mat4x4F32
+mat4x4f32_identity(void)
+{
+    Mat4x4F32 m = {0};
+    for(U64 i = 0;
+            i < 4;
+            i += 1)
+    {
+        m.v[i][i] = 1.0f;
+    }
+    return(m);
+}
+
+internal Mat4x4F32
+mat4x4f32_mul(
+        Mat4x4F32 a,
+        Mat4x4F32 b)
+{
+    Mat4x4F32 m = {0};
+    for(U64 r = 0;
+            r < 4;
+            r += 1)
+    {
+        for(U64 c = 0;
+                c < 4;
+                c += 1)
+        {
+            m.v[r][c] = a.v[r][0] * b.v[0][c] + a.v[r][1] * b.v[1][c] + a.v[r][2] * b.v[2][c] + a.v[r][3] * b.v[3][c];
+        }
+    }
+    return(m);
+}
+
+internal Vec4F32
+mat4x4f32_mul_vec4f32(
+        Mat4x4F32 m,
+        Vec4F32 v)
+{
+    Vec4F32 result = {0};
+    for(U64 r = 0;
+            r < 4;
+            r += 1)
+    {
+        result.v[r] = m.v[r][0] * v.x + m.v[r][1] * v.y + m.v[r][2] * v.z + m.v[r][3] * v.w;
+    }
+    return(result);
+}
+
+internal Mat4x4F32
+mat4x4f32_translate(
+        Vec3F32 delta)
+{
+    Mat4x4F32 m = mat4x4f32_identity();
+    m.v[0][3] = delta.x;
+    m.v[1][3] = delta.y;
+    m.v[2][3] = delta.z;
+    return(m);
+}
+
+internal Mat4x4F32
+mat4x4f32_scale(
+        Vec3F32 scale)
+{
+    Mat4x4F32 m = mat4x4f32_identity();
+    m.v[0][0] = scale.x;
+    m.v[1][1] = scale.y;
+    m.v[2][2] = scale.z;
+    return(m);
+}
+
+internal Mat4x4F32
+mat4x4f32_rotate_z(
+        F32 angle)
+{
+    F32 c = cosf(angle);
+    F32 s = sinf(angle);
+    Mat4x4F32 m = mat4x4f32_identity();
+    m.v[0][0] = c;
+    m.v[0][1] = -s;
+    m.v[1][0] = s;
+    m.v[1][1] = c;
+    return(m);
+}
+
+internal Mat4x4F32
+mat4x4f32_transpose(
+        Mat4x4F32 m)
+{
+    Mat4x4F32 result = {0};
+    for(U64 r = 0;
+            r < 4;
+            r += 1)
+    {
+        for(U64 c = 0;
+                c < 4;
+                c += 1)
+        {
+            result.v[c][r] = m.v[r][c];
+        }
+    }
+    return(result);
+}
+
+// IMPL Math: range operations
+internal Range1F32
+range1f32_make(
+        F32 min,
+        F32 max)
+{
+    return(min <= max ? (Range1F32){ .min = min, .max = max } : (Range1F32){ .min = max, .max = min });
+}
+
+internal F32
+range1f32_dim(
+        Range1F32 r)
+{
+    return(r.max - r.min);
+}
+
+internal B32
+range1f32_contains(
+        Range1F32 r,
+        F32 x)
+{
+    return(r.min <= x && x < r.max);
+}
+
+internal B32
+range1f32_overlaps(
+        Range1F32 a,
+        Range1F32 b)
+{
+    return(a.min < b.max && b.min < a.max);
+}
+
+internal Range1U64
+range1u64_make(
+        U64 min,
+        U64 max)
+{
+    return(min <= max ? (Range1U64){ .min = min, .max = max } : (Range1U64){ .min = max, .max = min });
+}
+
+internal U64
+range1u64_dim(
+        Range1U64 r)
+{
+    return(r.max - r.min);
+}
+
+internal Range2F32
+range2f32_make(
+        Vec2F32 min,
+        Vec2F32 max)
+{
+    Range2F32 r =
+    {
+        .min = vec2f32_make(Min(min.x, max.x), Min(min.y, max.y)),
+        .max = vec2f32_make(Max(min.x, max.x), Max(min.y, max.y)),
+    };
+    return(r);
+}
+
+internal Range2F32
+range2f32_from_rect(
+        F32 x,
+        F32 y,
+        F32 width,
+        F32 height)
+{
+    return(range2f32_make(vec2f32_make(x, y), vec2f32_make(x + width, y + height)));
+}
+
+internal Vec2F32
+range2f32_dim(
+        Range2F32 r)
+{
+    return(vec2f32_sub(r.max, r.min));
+}
+
+internal Vec2F32
+range2f32_center(
+        Range2F32 r)
+{
+    return(vec2f32_scale(vec2f32_add(r.min, r.max), 0.5f));
+}
+
+internal Range2F32
+range2f32_pad(
+        Range2F32 r,
+        F32 pad)
+{
+    return((Range2F32){ .x0 = r.x0 - pad, .y0 = r.y0 - pad, .x1 = r.x1 + pad, .y1 = r.y1 + pad });
+}
+
+internal Range2F32
+range2f32_shift(
+        Range2F32 r,
+        Vec2F32 delta)
+{
+    return((Range2F32){ .min = vec2f32_add(r.min, delta), .max = vec2f32_add(r.max, delta) });
+}
+
+internal Range2F32
+range2f32_union(
+        Range2F32 a,
+        Range2F32 b)
+{
+    return((Range2F32){ .x0 = Min(a.x0, b.x0), .y0 = Min(a.y0, b.y0), .x1 = Max(a.x1, b.x1), .y1 = Max(a.y1, b.y1) });
+}
+
+internal B32
+range2f32_contains(
+        Range2F32 r,
+        Vec2F32 p)
+{
+    return(r.x0 <= p.x && p.x < r.x1 && r.y0 <= p.y && p.y < r.y1);
+}
+
+internal B32
+range2f32_overlaps(
+        Range2F32 a,
+        Range2F32 b)
+{
+    return(a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1);
+}
+
+internal Range2S32
+range2s32_make(
+        Vec2S32 min,
+        Vec2S32 max)
+{
+    Range2S32 r =
+    {
+        .min = { .x = Min(min.x, max.x), .y = Min(min.y, max.y) },
+        .max = { .x = Max(min.x, max.x), .y = Max(min.y, max.y) },
+    };
+    return(r);
+}
+
+internal Vec2S32
+range2s32_dim(
+        Range2S32 r)
+{
+    return((Vec2S32){ .x = r.x1 - r.x0, .y = r.y1 - r.y0 });
+}
+
+// IMPL Math: batch kernels
+// angn: NOTE: the wide paths do the same operations in the same order as the
+// scalar versions, so results match bit for bit as long as the compiler is
+// not fusing multiply-adds. build.sh passes -ffp-contract=off for that, clang
+// would otherwise fuse on arm64 (and on x64 with -mfma)
+internal void
+vec2f32_add_batch(
+        Vec2F32 *out,
+        Vec2F32 *a,
+        Vec2F32 *b,
+        U64 count)
+{
+    F32 *o = (F32 *)out;
+    F32 *x = (F32 *)a;
+    F32 *y = (F32 *)b;
+    U64 floats_count = count * 2;
+    U64 i = 0;
+#if SIMD_AVX2
+    for(;
+            i + 8 <= floats_count;
+            i += 8)
+    {
+        _mm256_storeu_ps(o + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+#elif SIMD_SSE2
+    for(;
+            i + 4 <= floats_count;
+            i += 4)
+    {
+        _mm_storeu_ps(o + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_loadu_ps(y + i)));
+    }
+#elif SIMD_NEON
+    for(;
+            i + 4 <= floats_count;
+            i += 4)
+    {
+        vst1q_f32(o + i, vaddq_f32(vld1q_f32(x + i), vld1q_f32(y + i)));
+    }
+#endif
+    for(;
+            i < floats_count;
+            i += 1)
+    {
+        o[i] = x[i] + y[i];
+    }
+}
+
+internal void
+vec2f32_scale_batch(
+        Vec2F32 *out,
+        Vec2F32 *a,
+        F32 s,
+        U64 count)
+{
+    F32 *o = (F32 *)out;
+    F32 *x = (F32 *)a;
+    U64 floats_count = count * 2;
+    U64 i = 0;
+#if SIMD_AVX2
+    __m256 scale = _mm256_set1_ps(s);
+    for(;
+            i + 8 <= floats_count;
+            i += 8)
+    {
+        _mm256_storeu_ps(o + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), scale));
+    }
+#elif SIMD_SSE2
+    __m128 scale = _mm_set1_ps(s);
+    for(;
+            i + 4 <= floats_count;
+            i += 4)
+    {
+        _mm_storeu_ps(o + i, _mm_mul_ps(_mm_loadu_ps(x + i), scale));
+    }
+#elif SIMD_NEON
+    float32x4_t scale = vdupq_n_f32(s);
+    for(;
+            i + 4 <= floats_count;
+            i += 4)
+    {
+        vst1q_f32(o + i, vmulq_f32(vld1q_f32(x + i), scale));
+    }
+#endif
+    for(;
+            i < floats_count;
+            i += 1)
+    {
+        o[i] = x[i] * s;
+    }
+}
+
+// angn: x' = x*c - y*s, y' = y*c + x*s. Lanes hold [x y x y], the swapped
+// copy [y x y x] times [-s s -s s] gives the second term for both
+internal void
+vec2f32_rotate_batch(
+        Vec2F32 *out,
+        Vec2F32 *a,
+        F32 angle,
+        U64 count)
+{
+    F32 c = cosf(angle);
+    F32 s = sinf(angle);
+    F32 *o = (F32 *)out;
+    F32 *x = (F32 *)a;
+    U64 floats_count = count * 2;
+    U64 i = 0;
+#if SIMD_AVX2
+    __m256 cv = _mm256_set1_ps(c);
+    __m256 sv = _mm256_setr_ps(-s, s, -s, s, -s, s, -s, s);
+    for(;
+            i + 8 <= floats_count;
+            i += 8)
+    {
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 swapped = _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm256_storeu_ps(o + i, _mm256_add_ps(_mm256_mul_ps(v, cv), _mm256_mul_ps(swapped, sv)));
+    }
+#elif SIMD_SSE2
+    __m128 cv = _mm_set1_ps(c);
+    __m128 sv = _mm_setr_ps(-s, s, -s, s);
+    for(;
+            i + 4 <= floats_count;
+            i += 4)
+    {
+        __m128 v = _mm_loadu_ps(x + i);
+        __m128 swapped = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+        _mm_storeu_ps(o + i, _mm_add_ps(_mm_mul_ps(v, cv), _mm_mul_ps(swapped, sv)));
+    }
+#elif SIMD_NEON
+    float32x4_t cv = vdupq_n_f32(c);
+    F32 sv_lanes[4] = { -s, s, -s, s };
+    float32x4_t sv = vld1q_f32(sv_lanes);
+    for(;
+            i + 4 <= floats_count;
+            i += 4)
+    {
+        float32x4_t v = vld1q_f32(x + i);
+        float32x4_t swapped = vrev64q_f32(v);
+        vst1q_f32(o + i, vaddq_f32(vmulq_f32(v, cv), vmulq_f32(swapped, sv)));
+    }
+#endif
+    for(;
+            i < floats_count;
+            i += 2)
+    {
+        F32 vx = x[i];
+        F32 vy = x[i + 1];
+        F32 rx = vx * c;
+        F32 ry = vy * c;
+        F32 sx = vy * -s;
+        F32 sy = vx * s;
+        o[i] = rx + sx;
+        o[i + 1] = ry + sy;
+    }
+}
+
+// angn: the box and point kernels work on 4 elements at a time (8 with AVX2),
+// loading one element per row and transposing so each vector holds a single
+// field (x0, y0, x1, y1 or x, y, z, w) of every element. With AVX2 the low half
+// holds elements 0..3 and the high half 4..7, so the transpose stays in lanes
+#if SIMD_AVX2
+internal __m256
+batch_load2_m256(
+        F32 *lo,
+        F32 *hi)
+{
+    return(_mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(lo)), _mm_loadu_ps(hi), 1));
+}
+
+internal void
+batch_transpose4_m256(
+        __m256 *v0,
+        __m256 *v1,
+        __m256 *v2,
+        __m256 *v3)
+{
+    __m256 t0 = _mm256_unpacklo_ps(*v0, *v1);
+    __m256 t1 = _mm256_unpacklo_ps(*v2, *v3);
+    __m256 t2 = _mm256_unpackhi_ps(*v0, *v1);
+    __m256 t3 = _mm256_unpackhi_ps(*v2, *v3);
+    *v0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+    *v1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+    *v2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    *v3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+}
+#elif SIMD_SSE2
+internal void
+batch_transpose4_m128(
+        __m128 *v0,
+        __m128 *v1,
+        __m128 *v2,
+        __m128 *v3)
+{
+    __m128 t0 = _mm_unpacklo_ps(*v0, *v1);
+    __m128 t1 = _mm_unpacklo_ps(*v2, *v3);
+    __m128 t2 = _mm_unpackhi_ps(*v0, *v1);
+    __m128 t3 = _mm_unpackhi_ps(*v2, *v3);
+    *v0 = _mm_movelh_ps(t0, t1);
+    *v1 = _mm_movehl_ps(t1, t0);
+    *v2 = _mm_movelh_ps(t2, t3);
+    *v3 = _mm_movehl_ps(t3, t2);
+}
+#endif
+
+// angn: 4 movemask bits to 4 B8s. The multiply puts bit k at bit 8k (the
+// shifted copies don't overlap, so nothing carries) and the mask keeps those
+internal void
+batch_store_bits4(
+        B8 *out,
+        U32 bits)
+{
+    U32 bytes = ((bits & 0xf) * 0x00204081u) & 0x01010101u;
+    memcpy(out, &bytes, sizeof(bytes));
+}
+
+// angn: a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1 on whole
+// lanes of boxes, then one movemask bit per box goes out as a B8
+internal void
+range2f32_overlaps_batch(
+        B8 *out,
+        Range2F32 *a,
+        Range2F32 *b,
+        U64 count)
+{
+    F32 *af = (F32 *)a;
+    F32 *bf = (F32 *)b;
+    U64 i = 0;
+#if SIMD_AVX2
+    for(;
+            i + 8 <= count;
+            i += 8)
+    {
+        F32 *ap = af + i * 4;
+        F32 *bp = bf + i * 4;
+        __m256 ax0 = batch_load2_m256(ap + 0, ap + 16);
+        __m256 ay0 = batch_load2_m256(ap + 4, ap + 20);
+        __m256 ax1 = batch_load2_m256(ap + 8, ap + 24);
+        __m256 ay1 = batch_load2_m256(ap + 12, ap + 28);
+        __m256 bx0 = batch_load2_m256(bp + 0, bp + 16);
+        __m256 by0 = batch_load2_m256(bp + 4, bp + 20);
+        __m256 bx1 = batch_load2_m256(bp + 8, bp + 24);
+        __m256 by1 = batch_load2_m256(bp + 12, bp + 28);
+        batch_transpose4_m256(&ax0, &ay0, &ax1, &ay1);
+        batch_transpose4_m256(&bx0, &by0, &bx1, &by1);
+        __m256 x = _mm256_and_ps(_mm256_cmp_ps(ax0, bx1, _CMP_LT_OQ), _mm256_cmp_ps(bx0, ax1, _CMP_LT_OQ));
+        __m256 y = _mm256_and_ps(_mm256_cmp_ps(ay0, by1, _CMP_LT_OQ), _mm256_cmp_ps(by0, ay1, _CMP_LT_OQ));
+        U32 bits = (U32)_mm256_movemask_ps(_mm256_and_ps(x, y));
+        batch_store_bits4(out + i, bits);
+        batch_store_bits4(out + i + 4, bits >> 4);
+    }
+#elif SIMD_SSE2
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        F32 *ap = af + i * 4;
+        F32 *bp = bf + i * 4;
+        __m128 ax0 = _mm_loadu_ps(ap + 0);
+        __m128 ay0 = _mm_loadu_ps(ap + 4);
+        __m128 ax1 = _mm_loadu_ps(ap + 8);
+        __m128 ay1 = _mm_loadu_ps(ap + 12);
+        __m128 bx0 = _mm_loadu_ps(bp + 0);
+        __m128 by0 = _mm_loadu_ps(bp + 4);
+        __m128 bx1 = _mm_loadu_ps(bp + 8);
+        __m128 by1 = _mm_loadu_ps(bp + 12);
+        batch_transpose4_m128(&ax0, &ay0, &ax1, &ay1);
+        batch_transpose4_m128(&bx0, &by0, &bx1, &by1);
+        __m128 x = _mm_and_ps(_mm_cmplt_ps(ax0, bx1), _mm_cmplt_ps(bx0, ax1));
+        __m128 y = _mm_and_ps(_mm_cmplt_ps(ay0, by1), _mm_cmplt_ps(by0, ay1));
+        batch_store_bits4(out + i, (U32)_mm_movemask_ps(_mm_and_ps(x, y)));
+    }
+#elif SIMD_NEON
+    // angn: vld4 deinterleaves, so it does the transpose. NEON has no
+    // movemask, the lanes are narrowed to one byte each instead
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        float32x4x4_t av = vld4q_f32(af + i * 4);
+        float32x4x4_t bv = vld4q_f32(bf + i * 4);
+        uint32x4_t x = vandq_u32(vcltq_f32(av.val[0], bv.val[2]), vcltq_f32(bv.val[0], av.val[2]));
+        uint32x4_t y = vandq_u32(vcltq_f32(av.val[1], bv.val[3]), vcltq_f32(bv.val[1], av.val[3]));
+        uint8x8_t hits = vmovn_u16(vcombine_u16(vmovn_u32(vandq_u32(x, y)), vdup_n_u16(0)));
+        U32 bytes = vget_lane_u32(vreinterpret_u32_u8(vand_u8(hits, vdup_n_u8(1))), 0);
+        memcpy(out + i, &bytes, sizeof(bytes));
+    }
+#endif
+    for(;
+            i < count;
+            i += 1)
+    {
+        out[i] = (B8)range2f32_overlaps(a[i], b[i]);
+    }
+}
+
+// angn: out = m * in. Points are transposed into x/y/z/w lanes, each row of m
+// is summed left to right like mat4x4f32_mul_vec4f32 does, and the rows are
+// transposed back into points
+internal void
+mat4x4f32_transform_batch(
+        Vec4F32 *out,
+        Mat4x4F32 m,
+        Vec4F32 *in,
+        U64 count)
+{
+    F32 *of = (F32 *)out;
+    F32 *inf = (F32 *)in;
+    U64 i = 0;
+#if SIMD_AVX2
+    for(;
+            i + 8 <= count;
+            i += 8)
+    {
+        F32 *ip = inf + i * 4;
+        F32 *op = of + i * 4;
+        __m256 x = batch_load2_m256(ip + 0, ip + 16);
+        __m256 y = batch_load2_m256(ip + 4, ip + 20);
+        __m256 z = batch_load2_m256(ip + 8, ip + 24);
+        __m256 w = batch_load2_m256(ip + 12, ip + 28);
+        batch_transpose4_m256(&x, &y, &z, &w);
+        __m256 rows[4];
+        for(U64 r = 0;
+                r < 4;
+                r += 1)
+        {
+            __m256 sum = _mm256_mul_ps(_mm256_broadcast_ss(&m.v[r][0]), x);
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_broadcast_ss(&m.v[r][1]), y));
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_broadcast_ss(&m.v[r][2]), z));
+            rows[r] = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_broadcast_ss(&m.v[r][3]), w));
+        }
+        batch_transpose4_m256(&rows[0], &rows[1], &rows[2], &rows[3]);
+        _mm_storeu_ps(op + 0, _mm256_castps256_ps128(rows[0]));
+        _mm_storeu_ps(op + 4, _mm256_castps256_ps128(rows[1]));
+        _mm_storeu_ps(op + 8, _mm256_castps256_ps128(rows[2]));
+        _mm_storeu_ps(op + 12, _mm256_castps256_ps128(rows[3]));
+        _mm_storeu_ps(op + 16, _mm256_extractf128_ps(rows[0], 1));
+        _mm_storeu_ps(op + 20, _mm256_extractf128_ps(rows[1], 1));
+        _mm_storeu_ps(op + 24, _mm256_extractf128_ps(rows[2], 1));
+        _mm_storeu_ps(op + 28, _mm256_extractf128_ps(rows[3], 1));
+    }
+#elif SIMD_SSE2
+    // angn: SSE2 has no broadcast from memory, so m is splatted once up front
+    __m128 mv[4][4];
+    for(U64 r = 0;
+            r < 4;
+            r += 1)
+    {
+        for(U64 c = 0;
+                c < 4;
+                c += 1)
+        {
+            mv[r][c] = _mm_set1_ps(m.v[r][c]);
+        }
+    }
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        F32 *ip = inf + i * 4;
+        F32 *op = of + i * 4;
+        __m128 x = _mm_loadu_ps(ip + 0);
+        __m128 y = _mm_loadu_ps(ip + 4);
+        __m128 z = _mm_loadu_ps(ip + 8);
+        __m128 w = _mm_loadu_ps(ip + 12);
+        batch_transpose4_m128(&x, &y, &z, &w);
+        __m128 rows[4];
+        for(U64 r = 0;
+                r < 4;
+                r += 1)
+        {
+            __m128 sum = _mm_mul_ps(mv[r][0], x);
+            sum = _mm_add_ps(sum, _mm_mul_ps(mv[r][1], y));
+            sum = _mm_add_ps(sum, _mm_mul_ps(mv[r][2], z));
+            rows[r] = _mm_add_ps(sum, _mm_mul_ps(mv[r][3], w));
+        }
+        batch_transpose4_m128(&rows[0], &rows[1], &rows[2], &rows[3]);
+        _mm_storeu_ps(op + 0, rows[0]);
+        _mm_storeu_ps(op + 4, rows[1]);
+        _mm_storeu_ps(op + 8, rows[2]);
+        _mm_storeu_ps(op + 12, rows[3]);
+    }
+#elif SIMD_NEON
+    for(;
+            i + 4 <= count;
+            i += 4)
+    {
+        float32x4x4_t v = vld4q_f32(inf + i * 4);
+        float32x4x4_t rows;
+        for(U64 r = 0;
+                r < 4;
+                r += 1)
+        {
+            float32x4_t sum = vmulq_n_f32(v.val[0], m.v[r][0]);
+            sum = vaddq_f32(sum, vmulq_n_f32(v.val[1], m.v[r][1]));
+            sum = vaddq_f32(sum, vmulq_n_f32(v.val[2], m.v[r][2]));
+            rows.val[r] = vaddq_f32(sum, vmulq_n_f32(v.val[3], m.v[r][3]));
+        }
+        vst4q_f32(of + i * 4, rows);
+    }
+#endif
+    for(;
+            i < count;
+            i += 1)
+    {
+        out[i] = mat4x4f32_mul_vec4f32(m, in[i]);
+    }
+}
+
+#endif // IMPL_POUNDC_MATH
+
+/* IMPL STRING */
+#if IMPL_POUNDC_STRING
+#undef IMPL_POUNDC_STRING
+
+internal String8
+string8_make(
+        U8 *str,
+        U64 size)
+{
+    return((String8)
+            {
+                .string = str,
+                .size = size,
+            });
+}
+
+internal String8
+string8_from_cstring(
+        char *cstr)
+{
+    return((String8)
+            {
+                .string = (U8 *)cstr,
+                .size = (U64)strlen(cstr),
+            });
+}
+
+internal String8
+string8_from_range(
+        U8 *first,
+        U8 *one_past_last)
+{
+    return((String8)
             {
                 .string = first,
                 .size = (U64)(one_past_last - first),
             });
 }
 
-internal String8
-string8_make_zero(
-        void)
+internal String8
+string8_make_zero(
+        void)
+{
+    return((String8){0});
+}
+
+internal String8
+string8_slice(
+        String8 str,
+        Range1U64 range)
+{
+    Assert(range.min <= range.max);
+    U64 min = Min(range.min, str.size);
+    U64 max = Max(min, Min(range.max, str.size));
+    return((String8)
+            {
+                .string = str.string + min,
+                .size = max - min,
+            });
+}
+
+internal String8
+string8_prefix(
+        String8 str,
+        U64 size)
+{
+    str.size = Min(size, str.size);
+    return(str);
+}
+
+internal String8
+string8_skip(
+        String8 str,
+        U64 size)
+{
+    size = Min(size, str.size);
+    str.string += size;
+    str.size -= size;
+    return(str);
+}
+
+internal String8
+string8_chop(
+        String8 str,
+        U64 size)
+{
+    str.size -= Min(size, str.size);
+    return(str);
+}
+
+// IMPL STRING: comparison
+internal B32
+string8_match(
+        String8 a,
+        String8 b)
+{
+    return(a.size == b.size && (a.size == 0 || memcmp(a.string, b.string, a.size) == 0));
+}
+
+internal S32
+string8_compare(
+        String8 a,
+        String8 b)
+{
+    U64 size = Min(a.size, b.size);
+    S32 result = size ? memcmp(a.string, b.string, size) : 0;
+    if(result == 0)
+    {
+        result = (a.size > b.size) - (a.size < b.size);
+    }
+    return(result);
+}
+
+internal B32
+string8_starts_with(
+        String8 str,
+        String8 prefix)
+{
+    return(string8_match(string8_prefix(str, prefix.size), prefix));
+}
+
+internal B32
+string8_ends_with(
+        String8 str,
+        String8 suffix)
+{
+    return(str.size >= suffix.size && string8_match(string8_skip(str, str.size - suffix.size), suffix));
+}
+
+internal U64
+string8_find(
+        String8 str,
+        String8 needle,
+        U64 start)
+{
+    U64 result = str.size;
+    if(needle.size == 0)
+    {
+        return(Min(start, str.size));
+    }
+    for(U64 i = start;
+            i + needle.size <= str.size;
+            i += 1)
+    {
+        if(str.string[i] == needle.string[0] && memcmp(str.string + i, needle.string, needle.size) == 0)
+        {
+            result = i;
+            break;
+        }
+    }
+    return(result);
+}
+
+// IMPL STRING: building
+internal String8
+string8_push_copy(
+        Arena *arena,
+        String8 str)
+{
+    U8 *bytes = arena_push_array_no_zero(arena, U8, str.size + 1);
+    if(str.size)
+    {
+        memcpy(bytes, str.string, str.size);
+    }
+    bytes[str.size] = 0;
+    return(string8_make(bytes, str.size));
+}
+
+internal String8
+string8_push_concat(
+        Arena *arena,
+        String8 a,
+        String8 b)
+{
+    U8 *bytes = arena_push_array_no_zero(arena, U8, a.size + b.size + 1);
+    if(a.size)
+    {
+        memcpy(bytes, a.string, a.size);
+    }
+    if(b.size)
+    {
+        memcpy(bytes + a.size, b.string, b.size);
+    }
+    bytes[a.size + b.size] = 0;
+    return(string8_make(bytes, a.size + b.size));
+}
+
+internal String8
+string8_push_fmtv(
+        Arena *arena,
+        char *fmt,
+        va_list args)
+{
+    // angn: measure first, then format straight into the arena
+    va_list args_measure;
+    va_copy(args_measure, args);
+    int size = vsnprintf(0, 0, fmt, args_measure);
+    va_end(args_measure);
+
+    String8 result = {0};
+    if(size >= 0)
+    {
+        U8 *bytes = arena_push_array_no_zero(arena, U8, Cast(U64, size) + 1);
+        vsnprintf((char *)bytes, Cast(U64, size) + 1, fmt, args);
+        result = string8_make(bytes, Cast(U64, size));
+    }
+    return(result);
+}
+
+internal String8
+string8_push_fmt(
+        Arena *arena,
+        char *fmt,
+        ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    String8 result = string8_push_fmtv(arena, fmt, args);
+    va_end(args);
+    return(result);
+}
+
+internal void
+string8_list_push(
+        Arena *arena,
+        String8List *list,
+        String8 str)
+{
+    String8Node *node = arena_push_array_no_zero(arena, String8Node, 1);
+    node->next = 0;
+    node->string = str;
+    if(list->last)
+    {
+        list->last->next = node;
+    }
+    else
+    {
+        list->first = node;
+    }
+    list->last = node;
+    list->node_count += 1;
+    list->total_size += str.size;
+}
+
+internal void
+string8_list_push_fmt(
+        Arena *arena,
+        String8List *list,
+        char *fmt,
+        ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    String8 str = string8_push_fmtv(arena, fmt, args);
+    va_end(args);
+    string8_list_push(arena, list, str);
+}
+
+internal String8
+string8_list_join(
+        Arena *arena,
+        String8List *list,
+        String8 separator)
+{
+    U64 size = list->total_size + (list->node_count ? (list->node_count - 1) * separator.size : 0);
+    U8 *bytes = arena_push_array_no_zero(arena, U8, size + 1);
+    U64 offset = 0;
+    for EachSLLNode(String8Node, node, list->first, next)
+    {
+        if(node != list->first && separator.size)
+        {
+            memcpy(bytes + offset, separator.string, separator.size);
+            offset += separator.size;
+        }
+        if(node->string.size)
+        {
+            memcpy(bytes + offset, node->string.string, node->string.size);
+            offset += node->string.size;
+        }
+    }
+    bytes[size] = 0;
+    return(string8_make(bytes, size));
+}
+
+// IMPL STRING: interning
+internal String8InternTable
+string8_intern_table_make(
+        Arena *arena,
+        U64 capacity)
+{
+    String8InternTable table = {0};
+    table.arena = arena;
+    table.ids = hash_map_make(arena, HashMapKeyKind_String8, sizeof(String8), sizeof(U32), capacity);
+    table.capacity = Max(capacity + 1, 16);
+    table.strings = arena_push_array(arena, String8, table.capacity);
+    table.count = 1;
+    return(table);
+}
+
+internal U32
+string8_intern(
+        String8InternTable *table,
+        String8 str)
+{
+    U32 *id = (U32 *)hash_map_lookup(&table->ids, &str);
+    if(id)
+    {
+        return(*id);
+    }
+
+    //- angn: first sighting, copy the bytes so the key outlives the caller's
+    if(table->count == table->capacity)
+    {
+        String8 *strings = arena_push_array_no_zero(table->arena, String8, table->capacity * 2);
+        memcpy(strings, table->strings, sizeof(String8) * table->count);
+        table->strings = strings;
+        table->capacity *= 2;
+    }
+    String8 copy = string8_push_copy(table->arena, str);
+    U32 new_id = Cast(U32, table->count);
+    table->strings[new_id] = copy;
+    table->count += 1;
+    *(U32 *)hash_map_insert(&table->ids, &copy, 0) = new_id;
+    return(new_id);
+}
+
+internal U32
+string8_intern_lookup(
+        String8InternTable *table,
+        String8 str)
+{
+    U32 *id = (U32 *)hash_map_lookup(&table->ids, &str);
+    return(id ? *id : 0);
+}
+
+internal String8
+string8_from_intern_id(
+        String8InternTable *table,
+        U32 id)
+{
+    Assert(id < table->count);
+    return(id < table->count ? table->strings[id] : string8_make_zero());
+}
+
+#endif // IMPL_POUNDC_STRING
+
+/* IMPL HASH */
+#if IMPL_POUNDC_HASH
+#undef IMPL_POUNDC_HASH
+
+global U64 hash_secret[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+// angn: full 64x64 -> 128 multiply, low half into a, high half into b
+internal void
+hash_multiply(
+        U64 *a,
+        U64 *b)
+{
+#if COMPILER_MSVC
+    U64 high = 0;
+    *a = _umul128(*a, *b, &high);
+    *b = high;
+#else
+    __extension__ typedef unsigned __int128 U128;
+    U128 r = Cast(U128, *a) * *b;
+    *a = Cast(U64, r);
+    *b = Cast(U64, r >> 64);
+#endif
+}
+
+internal U64
+hash_mix(
+        U64 a,
+        U64 b)
+{
+    hash_multiply(&a, &b);
+    return(a ^ b);
+}
+
+// angn: NOTE: little endian reads, every target we build for is
+internal U64
+hash_read_u64(
+        U8 *p)
+{
+    U64 v = 0;
+    memcpy(&v, p, sizeof(v));
+    return(v);
+}
+
+internal U64
+hash_read_u32(
+        U8 *p)
+{
+    U32 v = 0;
+    memcpy(&v, p, sizeof(v));
+    return(v);
+}
+
+internal U64
+hash_u64_from_bytes(
+        void *data,
+        U64 size,
+        U64 seed)
+{
+    U8 *p = (U8 *)data;
+    seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+    U64 a = 0;
+    U64 b = 0;
+    if(size <= 16)
+    {
+        if(size >= 4)
+        {
+            U64 middle = (size >> 3) << 2;
+            a = (hash_read_u32(p) << 32) | hash_read_u32(p + middle);
+            b = (hash_read_u32(p + size - 4) << 32) | hash_read_u32(p + size - 4 - middle);
+        }
+        else if(size > 0)
+        {
+            a = (Cast(U64, p[0]) << 16) | (Cast(U64, p[size >> 1]) << 8) | p[size - 1];
+        }
+    }
+    else
+    {
+        U64 left = size;
+        if(left >= 48)
+        {
+            U64 seed1 = seed;
+            U64 seed2 = seed;
+            for(;
+                    left >= 48;
+                    left -= 48, p += 48)
+            {
+                seed = hash_mix(hash_read_u64(p) ^ hash_secret[1], hash_read_u64(p + 8) ^ seed);
+                seed1 = hash_mix(hash_read_u64(p + 16) ^ hash_secret[2], hash_read_u64(p + 24) ^ seed1);
+                seed2 = hash_mix(hash_read_u64(p + 32) ^ hash_secret[3], hash_read_u64(p + 40) ^ seed2);
+            }
+            seed ^= seed1 ^ seed2;
+        }
+        for(;
+                left > 16;
+                left -= 16, p += 16)
+        {
+            seed = hash_mix(hash_read_u64(p) ^ hash_secret[1], hash_read_u64(p + 8) ^ seed);
+        }
+        a = hash_read_u64(p + left - 16);
+        b = hash_read_u64(p + left - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_multiply(&a, &b);
+    return(hash_mix(a ^ hash_secret[0] ^ size, b ^ hash_secret[1]));
+}
+
+internal U64
+hash_u64(
+        U64 x)
+{
+    return(hash_mix(x ^ hash_secret[0], HASH_SEED_DEFAULT ^ hash_secret[1]));
+}
+
+internal U64
+string8_hash(
+        String8 str)
+{
+    return(hash_u64_from_bytes(str.string, str.size, HASH_SEED_DEFAULT));
+}
+
+// IMPL HASH: map
+// angn: bit i set where control byte i of the group equals byte
+internal U32
+hash_map_group_match(
+        U8 *group,
+        U8 byte)
+{
+    U32 mask = 0;
+#if SIMD_SSE2
+    __m128i controls = _mm_loadu_si128((__m128i *)group);
+    mask = Cast(U32, _mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(Cast(char, byte)))));
+#elif SIMD_NEON
+    local_persist const U8 bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t matches = vandq_u8(vceqq_u8(vld1q_u8(group), vdupq_n_u8(byte)), vld1q_u8(bits));
+    mask = Cast(U32, vaddv_u8(vget_low_u8(matches))) | (Cast(U32, vaddv_u8(vget_high_u8(matches))) << 8);
+#else
+    for(U64 i = 0;
+            i < HASH_MAP_GROUP_SIZE;
+            i += 1)
+    {
+        mask |= Cast(U32, group[i] == byte) << i;
+    }
+#endif
+    return(mask);
+}
+
+internal U64
+hash_map_hash_key(
+        HashMap *map,
+        void *key)
+{
+    U64 hash = 0;
+    if(map->key_kind == HashMapKeyKind_String8)
+    {
+        hash = string8_hash(*(String8 *)key);
+    }
+    else
+    {
+        hash = hash_u64_from_bytes(key, map->key_size, HASH_SEED_DEFAULT);
+    }
+    return(hash);
+}
+
+internal B32
+hash_map_key_match(
+        HashMap *map,
+        void *a,
+        void *b)
+{
+    B32 match = 0;
+    if(map->key_kind == HashMapKeyKind_String8)
+    {
+        match = string8_match(*(String8 *)a, *(String8 *)b);
+    }
+    else
+    {
+        match = memcmp(a, b, map->key_size) == 0;
+    }
+    return(match);
+}
+
+// angn: the slot holding key, or the first free slot on its probe sequence
+// with found = 0, -1 when the table is full
+internal S64
+hash_map_find(
+        HashMap *map,
+        void *key,
+        U64 hash,
+        B32 *found)
+{
+    *found = 0;
+    if(map->capacity == 0)
+    {
+        return(-1);
+    }
+
+    // angn: high bits pick the group, the low 7 go into the control byte
+    U64 groups_mask = map->capacity / HASH_MAP_GROUP_SIZE - 1;
+    U64 group_index = (hash >> 7) & groups_mask;
+    U8 tag = Cast(U8, hash & 0x7f);
+    S64 free_slot = -1;
+
+    // angn: triangular steps visit every group once when the count is a power of two
+    for(U64 step = 0;
+            step <= groups_mask;
+            step += 1)
+    {
+        U8 *group = map->control + group_index * HASH_MAP_GROUP_SIZE;
+        for(U32 matches = hash_map_group_match(group, tag);
+                matches != 0;
+                matches &= matches - 1)
+        {
+            U64 slot = group_index * HASH_MAP_GROUP_SIZE + CountTrailingZerosU64(matches);
+            if(hash_map_key_match(map, map->slots + slot * map->slot_size, key))
+            {
+                *found = 1;
+                return(Cast(S64, slot));
+            }
+        }
+
+        if(free_slot < 0)
+        {
+            U32 deleted = hash_map_group_match(group, HASH_MAP_CONTROL_DELETED);
+            if(deleted)
+            {
+                free_slot = Cast(S64, group_index * HASH_MAP_GROUP_SIZE + CountTrailingZerosU64(deleted));
+            }
+        }
+
+        // angn: an empty slot ends the chain, the key was never pushed past it
+        U32 empty = hash_map_group_match(group, HASH_MAP_CONTROL_EMPTY);
+        if(empty)
+        {
+            if(free_slot < 0)
+            {
+                free_slot = Cast(S64, group_index * HASH_MAP_GROUP_SIZE + CountTrailingZerosU64(empty));
+            }
+            break;
+        }
+        group_index = (group_index + step + 1) & groups_mask;
+    }
+    return(free_slot);
+}
+
+internal void
+hash_map_rehash(
+        HashMap *map,
+        U64 capacity)
+{
+    HashMap old = *map;
+    map->capacity = capacity;
+    map->count = 0;
+    map->deleted_count = 0;
+    map->control = arena_push_array_no_zero_aligned(map->arena, U8, capacity, HASH_MAP_GROUP_SIZE);
+    map->slots = arena_push_array_no_zero_aligned(map->arena, U8, capacity * map->slot_size, 16);
+    memset(map->control, HASH_MAP_CONTROL_EMPTY, capacity);
+
+    for(U64 slot = 0;
+            slot < old.capacity;
+            slot += 1)
+    {
+        if(old.control[slot] & 0x80)
+        {
+            continue;
+        }
+        U8 *old_slot = old.slots + slot * old.slot_size;
+        B32 found = 0;
+        S64 new_slot = hash_map_find(map, old_slot, hash_map_hash_key(map, old_slot), &found);
+        Assert(new_slot >= 0 && !found);
+        map->control[new_slot] = old.control[slot];
+        memcpy(map->slots + new_slot * map->slot_size, old_slot, map->slot_size);
+        map->count += 1;
+    }
+}
+
+// angn: groups needed to hold count at 7/8 load
+internal U64
+hash_map_capacity_for(
+        U64 count)
 {
-    return((String8){0});
+    U64 capacity = HASH_MAP_GROUP_SIZE;
+    for(;
+            capacity * 7 / 8 < count;
+            capacity *= 2)
+    {
+    }
+    return(capacity);
 }
 
-internal String8
-string8_slice(
-        String8 str,
-        Range1U64 range)
+internal HashMap
+hash_map_make(
+        Arena *arena,
+        HashMapKeyKind key_kind,
+        U64 key_size,
+        U64 value_size,
+        U64 capacity)
 {
-    Assert(range.v[0] <= range.v[1]);
-    U64 shift_right = Min(range.v[0], str.size - 1);
-    U64 shift_left = range.v[1];
-    return((String8)
-            {
-                .string = str.string + shift_right,
-                .size = str.size - shift_right - shift_left,
-            });
+    HashMap map = {0};
+    map.arena = arena;
+    map.key_kind = key_kind;
+    map.key_size = key_size;
+    map.value_size = value_size;
+    map.value_offset = AlignUpPow2(key_size, 8);
+    map.slot_size = AlignUpPow2(map.value_offset + value_size, 8);
+    if(capacity > 0)
+    {
+        hash_map_rehash(&map, hash_map_capacity_for(capacity));
+    }
+    return(map);
 }
 
-#endif // IMPL_POUNDC_STRING
+internal void *
+hash_map_lookup(
+        HashMap *map,
+        void *key)
+{
+    B32 found = 0;
+    S64 slot = hash_map_find(map, key, hash_map_hash_key(map, key), &found);
+    return(found ? map->slots + slot * map->slot_size + map->value_offset : 0);
+}
+
+internal void *
+hash_map_insert(
+        HashMap *map,
+        void *key,
+        B32 *found)
+{
+    U64 hash = hash_map_hash_key(map, key);
+    B32 key_found = 0;
+    S64 slot = hash_map_find(map, key, hash, &key_found);
+    if(!key_found)
+    {
+        // angn: grow, or just sweep out the tombstones when they are what filled it
+        if(map->capacity == 0 || (map->count + map->deleted_count + 1) > map->capacity * 7 / 8)
+        {
+            hash_map_rehash(map, Max(map->capacity, hash_map_capacity_for(2 * (map->count + 1))));
+            slot = hash_map_find(map, key, hash, &key_found);
+        }
+        Assert(slot >= 0);
+        if(map->control[slot] == HASH_MAP_CONTROL_DELETED)
+        {
+            map->deleted_count -= 1;
+        }
+        map->control[slot] = Cast(U8, hash & 0x7f);
+        map->count += 1;
+        U8 *slot_memory = map->slots + slot * map->slot_size;
+        memcpy(slot_memory, key, map->key_size);
+        memset(slot_memory + map->value_offset, 0, map->value_size);
+    }
+    if(found)
+    {
+        *found = key_found;
+    }
+    return(map->slots + slot * map->slot_size + map->value_offset);
+}
+
+internal B32
+hash_map_remove(
+        HashMap *map,
+        void *key)
+{
+    B32 found = 0;
+    S64 slot = hash_map_find(map, key, hash_map_hash_key(map, key), &found);
+    if(found)
+    {
+        // angn: a group with an empty slot never had a probe pass through it
+        U64 group_index = Cast(U64, slot) / HASH_MAP_GROUP_SIZE;
+        if(hash_map_group_match(map->control + group_index * HASH_MAP_GROUP_SIZE, HASH_MAP_CONTROL_EMPTY))
+        {
+            map->control[slot] = HASH_MAP_CONTROL_EMPTY;
+        }
+        else
+        {
+            map->control[slot] = HASH_MAP_CONTROL_DELETED;
+            map->deleted_count += 1;
+        }
+        map->count -= 1;
+    }
+    return(found);
+}
+
+internal void
+hash_map_reserve(
+        HashMap *map,
+        U64 count)
+{
+    U64 capacity = hash_map_capacity_for(count);
+    if(capacity > map->capacity)
+    {
+        hash_map_rehash(map, capacity);
+    }
+}
+
+internal void
+hash_map_clear(
+        HashMap *map)
+{
+    if(map->capacity > 0)
+    {
+        memset(map->control, HASH_MAP_CONTROL_EMPTY, map->capacity);
+    }
+    map->count = 0;
+    map->deleted_count = 0;
+}
+
+internal HashMapIterator
+hash_map_iterator_make(
+        HashMap *map)
+{
+    return((HashMapIterator){ .map = map, .index = Cast(U64, -1) });
+}
+
+internal B32
+hash_map_iterator_next(
+        HashMapIterator *iterator)
+{
+    HashMap *map = iterator->map;
+    for(iterator->index += 1;
+            iterator->index < map->capacity;
+            iterator->index += 1)
+    {
+        if(!(map->control[iterator->index] & 0x80))
+        {
+            U8 *slot = map->slots + iterator->index * map->slot_size;
+            iterator->key = slot;
+            iterator->value = slot + map->value_offset;
+            return(1);
+        }
+    }
+    return(0);
+}
+
+#endif // IMPL_POUNDC_HASH
+
+/* IMPL RANDOM */
+#if IMPL_POUNDC_RANDOM
+#undef IMPL_POUNDC_RANDOM
+
+#define RANDOM_PCG32_MULTIPLIER 6364136223846793005ull
+
+internal U32
+random_u32(
+        RandomState *random)
+{
+    U64 old_state = random->state;
+    random->state = old_state * RANDOM_PCG32_MULTIPLIER + random->increment;
+    U32 xorshifted = (U32)(((old_state >> 18) ^ old_state) >> 27);
+    U32 rotation = (U32)(old_state >> 59);
+    return((xorshifted >> rotation) | (xorshifted << ((0u - rotation) & 31)));
+}
+
+internal RandomState
+random_make(
+        U64 seed,
+        U64 stream)
+{
+    RandomState random = { .state = 0, .increment = (stream << 1) | 1 };
+    random_u32(&random);
+    random.state += seed;
+    random_u32(&random);
+    return(random);
+}
+
+internal RandomState
+random_split(
+        RandomState *parent,
+        U64 stream)
+{
+    return(random_make(random_u64(parent), stream));
+}
+
+internal U64
+random_u64(
+        RandomState *random)
+{
+    U64 high = random_u32(random);
+    U64 low = random_u32(random);
+    return(U64FromTwoU32s(high, low));
+}
+
+internal U32
+random_u32_bounded(
+        RandomState *random,
+        U32 bound)
+{
+    // angn: Lemire, only rerolls when the low half lands in the biased sliver
+    U64 m = (U64)random_u32(random) * (U64)bound;
+    U32 low = (U32)m;
+    if(low < bound)
+    {
+        U32 threshold = (0u - bound) % bound;
+        for(;low < threshold;)
+        {
+            m = (U64)random_u32(random) * (U64)bound;
+            low = (U32)m;
+        }
+    }
+    return((U32)(m >> 32));
+}
+
+internal F32
+random_f32(
+        RandomState *random)
+{
+    return((F32)(random_u32(random) >> 8) * (1.0f / 16777216.0f));
+}
+
+internal void
+random_fill_u32(
+        RandomState *random,
+        U32 *out,
+        U64 count)
+{
+    // angn: state lives in registers for the whole batch
+    RandomState local = *random;
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        out[i] = random_u32(&local);
+    }
+    *random = local;
+}
+
+internal void
+random_fill_u32_bounded(
+        RandomState *random,
+        U32 *out,
+        U64 count,
+        U32 bound)
+{
+    RandomState local = *random;
+    for(U64 i = 0;
+            i < count;
+            i += 1)
+    {
+        out[i] = random_u32_bounded(&local, bound);
+    }
+    *random = local;
+}
+
+#endif // IMPL_POUNDC_RANDOM
 
 
 /* IMPL OS */
@@ -890,64 +3547,450 @@ os_init(
         info->large_page_size = MegaBytes(2);
         info->allocation_granularity = info->page_size;
 
-        // angn: TODO: multicore by default, thread context allocator
+        // angn: TODO: multicore by default, thread context allocator
+
+        // global allocator
+        g_os_linux_state.arena = arena_make();
+    }
+
+    return(0);
+}
+
+internal void *
+os_reserve(
+        U64 size)
+{
+    void *map = mmap(0, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if(map == MAP_FAILED) { map = 0; }
+    return(map);
+}
+
+internal void
+os_release(
+        void *ptr,
+        U64 size)
+{
+    munmap(ptr, size);
+}
+
+internal void *
+os_reserve_large(
+        U64 size)
+{
+    void *map = mmap(0, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if(map == MAP_FAILED) { map = 0; }
+    return(map);
+}
+
+internal B32
+os_commit_large(
+        void *ptr, U64 size)
+{
+    mprotect(ptr, size, PROT_READ|PROT_WRITE);
+    return(1);
+}
+
+internal B32
+os_commit(
+        void *ptr,
+        U64 size)
+{
+    return(mprotect(ptr, size, PROT_READ|PROT_WRITE) == 0);
+}
+
+internal void
+os_decommit(
+        void *ptr,
+        U64 size)
+{
+    madvise(ptr, size, MADV_DONTNEED);
+    mprotect(ptr, size, PROT_NONE);
+}
+
+internal void *
+os_linux_thread_entry(
+        void *ptr)
+{
+    OS_Linux_Thread *thread = (OS_Linux_Thread *)ptr;
+    thread->func(thread->params);
+    return(0);
+}
+
+internal OS_Handle
+os_thread_launch(
+        OS_ThreadFunction *func,
+        void *params)
+{
+    OS_Linux_Thread *thread = arena_push_array(g_os_linux_state.arena, OS_Linux_Thread, 1);
+    thread->func = func;
+    thread->params = params;
+    if(pthread_create(&thread->handle, 0, os_linux_thread_entry, thread) != 0)
+    {
+        thread = 0;
+    }
+    return((OS_Handle){ .u64 = { IntFromPtr(thread) } });
+}
+
+internal void
+os_thread_join(
+        OS_Handle thread)
+{
+    OS_Linux_Thread *t = (OS_Linux_Thread *)PtrFromInt(thread.u64[0]);
+    if(t != 0)
+    {
+        pthread_join(t->handle, 0);
+    }
+}
+
+internal OS_Handle
+os_semaphore_alloc(
+        U32 initial_count)
+{
+    sem_t *semaphore = arena_push_array(g_os_linux_state.arena, sem_t, 1);
+    if(sem_init(semaphore, 0, initial_count) != 0)
+    {
+        semaphore = 0;
+    }
+    return((OS_Handle){ .u64 = { IntFromPtr(semaphore) } });
+}
+
+internal void
+os_semaphore_release(
+        OS_Handle semaphore)
+{
+    sem_t *s = (sem_t *)PtrFromInt(semaphore.u64[0]);
+    if(s != 0)
+    {
+        sem_destroy(s);
+    }
+}
+
+internal void
+os_semaphore_signal(
+        OS_Handle semaphore,
+        U32 count)
+{
+    sem_t *s = (sem_t *)PtrFromInt(semaphore.u64[0]);
+    for(U32 i = 0;
+            i < count;
+            i += 1)
+    {
+        sem_post(s);
+    }
+}
+
+internal void
+os_semaphore_wait(
+        OS_Handle semaphore)
+{
+    sem_t *s = (sem_t *)PtrFromInt(semaphore.u64[0]);
+    for(;sem_wait(s) != 0;) {} // angn: NOTE: EINTR, a signal landed while waiting
+}
+
+internal U64
+os_now_microseconds(
+        void)
+{
+    struct timespec t = {0};
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return((U64)t.tv_sec * 1000000 + (U64)t.tv_nsec / 1000);
+}
+
+internal void
+os_sleep_milliseconds(
+        U32 msec)
+{
+    usleep(msec * 1000);
+}
+
+// angn: fds are stored plus one, fd 0 is a real file once stdin is closed
+// and a zeroed handle still has to mean invalid
+internal int
+os_linux_fd_from_handle(
+        OS_Handle file)
+{
+    return((int)file.u64[0] - 1);
+}
+
+internal OS_Handle
+os_file_open(
+        OS_AccessFlags flags,
+        String8 path)
+{
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+
+    int oflags = 0;
+    if((flags & OS_AccessFlag_Read) && (flags & OS_AccessFlag_Write)) { oflags = O_RDWR; }
+    else if(flags & OS_AccessFlag_Write) { oflags = O_WRONLY; }
+    else { oflags = O_RDONLY; }
+    if(flags & OS_AccessFlag_Write) { oflags |= O_CREAT; }
+    if(!(flags & OS_AccessFlag_Read)) { oflags |= O_TRUNC; }
+
+    OS_Handle result = {0};
+    int fd = open(path_cstr, oflags, 0644);
+    if(fd >= 0)
+    {
+        result.u64[0] = (U64)fd + 1;
+    }
+    return(result);
+}
+
+internal void
+os_file_close(
+        OS_Handle file)
+{
+    if(file.u64[0] != 0)
+    {
+        close(os_linux_fd_from_handle(file));
+    }
+}
+
+internal U64
+os_file_size(
+        OS_Handle file)
+{
+    U64 result = 0;
+    struct stat st = {0};
+    if(file.u64[0] != 0 && fstat(os_linux_fd_from_handle(file), &st) == 0)
+    {
+        result = (U64)st.st_size;
+    }
+    return(result);
+}
+
+internal U64
+os_file_read(
+        OS_Handle file,
+        U64 offset,
+        void *out,
+        U64 size)
+{
+    U64 total = 0;
+    if(file.u64[0] != 0)
+    {
+        for(;total < size;)
+        {
+            ssize_t amount = pread(os_linux_fd_from_handle(file), (U8 *)out + total, size - total, (off_t)(offset + total));
+            if(amount <= 0) { break; }
+            total += (U64)amount;
+        }
+    }
+    return(total);
+}
+
+internal U64
+os_file_write(
+        OS_Handle file,
+        U64 offset,
+        void *data,
+        U64 size)
+{
+    U64 total = 0;
+    if(file.u64[0] != 0)
+    {
+        for(;total < size;)
+        {
+            ssize_t amount = pwrite(os_linux_fd_from_handle(file), (U8 *)data + total, size - total, (off_t)(offset + total));
+            if(amount <= 0) { break; }
+            total += (U64)amount;
+        }
+    }
+    return(total);
+}
+
+internal U64
+os_file_modified_time(
+        String8 path)
+{
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
 
-        // global allocator
-        g_os_linux_state.arena = arena_make();
+    U64 result = 0;
+    struct stat st = {0};
+    if(stat(path_cstr, &st) == 0)
+    {
+        result = (U64)st.st_mtim.tv_sec * 1000000000ull + (U64)st.st_mtim.tv_nsec;
     }
+    return(result);
+}
 
-    return(0);
+internal B32
+os_file_delete(
+        String8 path)
+{
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+    return(unlink(path_cstr) == 0);
 }
 
-internal void *
-os_reserve(
-        U64 size)
+internal OS_Handle
+os_library_open(
+        String8 path)
 {
-    void *map = mmap(0, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
-    if(map == MAP_FAILED) { map = 0; }
-    return(map);
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+    return((OS_Handle){ .u64 = { IntFromPtr(dlopen(path_cstr, RTLD_NOW|RTLD_LOCAL)) } });
+}
+
+internal VoidProc *
+os_library_load_proc(
+        OS_Handle library,
+        char *name)
+{
+    VoidProc *result = 0;
+    if(library.u64[0] != 0)
+    {
+        result = (VoidProc *)dlsym(PtrFromInt(library.u64[0]), name);
+    }
+    return(result);
 }
 
 internal void
-os_release(
-        void *ptr,
-        U64 size)
+os_library_close(
+        OS_Handle library)
 {
-    munmap(ptr, size);
+    if(library.u64[0] != 0)
+    {
+        dlclose(PtrFromInt(library.u64[0]));
+    }
 }
 
-internal void *
-os_reserve_large(
-        U64 size)
+internal OS_FileMap
+os_file_map(
+        String8 path)
 {
-    void *map = mmap(0, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
-    if(map == MAP_FAILED) { map = 0; }
+    OS_FileMap map = {0};
+
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+
+    int fd = open(path_cstr, O_RDONLY);
+    if(fd >= 0)
+    {
+        struct stat st = {0};
+        if(fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void *base = mmap(0, (U64)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(base != MAP_FAILED)
+            {
+                map.base = base;
+                map.size = (U64)st.st_size;
+            }
+        }
+        close(fd);
+    }
+
     return(map);
 }
 
-internal B32
-os_commit_large(
-        void *ptr, U64 size)
+internal void
+os_file_unmap(
+        OS_FileMap map)
 {
-    mprotect(ptr, size, PROT_READ|PROT_WRITE);
-    return(1);
+    if(map.base != 0)
+    {
+        munmap(map.base, map.size);
+    }
+}
+
+internal OS_Handle
+os_file_watch_open(
+        void)
+{
+    OS_Handle result = {0};
+    int fd = inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+    if(fd >= 0)
+    {
+        OS_Linux_FileWatch *watch = arena_push_array(g_os_linux_state.arena, OS_Linux_FileWatch, 1);
+        watch->fd = fd;
+        result.u64[0] = IntFromPtr(watch);
+    }
+    return(result);
 }
 
 internal B32
-os_commit(
-        void *ptr,
-        U64 size)
+os_file_watch_add_directory(
+        OS_Handle handle,
+        String8 path)
 {
-    return(mprotect(ptr, size, PROT_READ|PROT_WRITE) == 0);
+    B32 result = 0;
+    OS_Linux_FileWatch *watch = (OS_Linux_FileWatch *)PtrFromInt(handle.u64[0]);
+    if(watch != 0 && watch->directories_count < OS_FILE_WATCH_DIRECTORIES_MAX)
+    {
+        char path_cstr[OS_PATH_MAX] = {0};
+        memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+
+        int wd = inotify_add_watch(watch->fd, path_cstr, IN_CLOSE_WRITE|IN_MOVED_TO);
+        if(wd >= 0)
+        {
+            U8 *copy = arena_push_array_no_zero(g_os_linux_state.arena, U8, path.size);
+            memcpy(copy, path.string, path.size);
+            watch->wds[watch->directories_count] = wd;
+            watch->directories[watch->directories_count] = string8_make(copy, path.size);
+            watch->directories_count += 1;
+            result = 1;
+        }
+    }
+    return(result);
 }
 
-internal void
-os_decommit(
-        void *ptr,
-        U64 size)
+internal OS_FileWatchEventList
+os_file_watch_wait(
+        Arena *arena,
+        OS_Handle handle,
+        U32 timeout_msec)
 {
-    madvise(ptr, size, MADV_DONTNEED);
-    mprotect(ptr, size, PROT_NONE);
+    OS_FileWatchEventList list = {0};
+    OS_Linux_FileWatch *watch = (OS_Linux_FileWatch *)PtrFromInt(handle.u64[0]);
+    if(watch == 0)
+    {
+        os_sleep_milliseconds(timeout_msec);
+        return(list);
+    }
+
+    struct pollfd pfd = { .fd = watch->fd, .events = POLLIN };
+    if(poll(&pfd, 1, (int)timeout_msec) <= 0)
+    {
+        return(list);
+    }
+
+    AlignAs(8) U8 buffer[4096];
+    for(;;)
+    {
+        ssize_t size = read(watch->fd, buffer, sizeof(buffer));
+        if(size <= 0) { break; }
+
+        for(U8 *at = buffer;
+                at < buffer + size;
+                at += sizeof(struct inotify_event) + ((struct inotify_event *)at)->len)
+        {
+            struct inotify_event *event = (struct inotify_event *)at;
+            if(event->len == 0) { continue; }
+
+            for(U32 di = 0;
+                    di < watch->directories_count;
+                    di += 1)
+            {
+                if(watch->wds[di] != event->wd) { continue; }
+
+                String8 directory = watch->directories[di];
+                U64 name_size = strlen(event->name);
+                U8 *path = arena_push_array_no_zero(arena, U8, directory.size + 1 + name_size + 1);
+                memcpy(path, directory.string, directory.size);
+                path[directory.size] = '/';
+                memcpy(path + directory.size + 1, event->name, name_size + 1);
+
+                OS_FileWatchEvent *node = arena_push_array(arena, OS_FileWatchEvent, 1);
+                node->path = string8_make(path, directory.size + 1 + name_size);
+                SLLStackPush_N(list.first, node, next);
+                list.count += 1;
+                break;
+            }
+        }
+    }
+
+    return(list);
 }
 
 #endif // OS_LINUX
@@ -971,6 +4014,13 @@ os_init(
         g_os_win32_state.arena = arena_make();
     }
 
+    // setup timer
+    LARGE_INTEGER frequency = {0};
+    if(QueryPerformanceFrequency(&frequency))
+    {
+        g_os_win32_state.microsecond_resolution = (U64)frequency.QuadPart;
+    }
+
     return(0);
 }
 
@@ -1026,8 +4076,372 @@ os_decommit(
     VirtualFree(ptr, size, MEM_DECOMMIT);
 }
 
+internal DWORD WINAPI
+os_win32_thread_entry(
+        void *ptr)
+{
+    OS_Win32_Thread *thread = (OS_Win32_Thread *)ptr;
+    thread->func(thread->params);
+    return(0);
+}
+
+internal OS_Handle
+os_thread_launch(
+        OS_ThreadFunction *func,
+        void *params)
+{
+    OS_Win32_Thread *thread = arena_push_array(g_os_win32_state.arena, OS_Win32_Thread, 1);
+    thread->func = func;
+    thread->params = params;
+    thread->handle = CreateThread(0, 0, os_win32_thread_entry, thread, 0, 0);
+    if(thread->handle == 0)
+    {
+        thread = 0;
+    }
+    return((OS_Handle){ .u64 = { IntFromPtr(thread) } });
+}
+
+internal void
+os_thread_join(
+        OS_Handle thread)
+{
+    OS_Win32_Thread *t = (OS_Win32_Thread *)PtrFromInt(thread.u64[0]);
+    if(t != 0)
+    {
+        WaitForSingleObject(t->handle, INFINITE);
+        CloseHandle(t->handle);
+    }
+}
+
+internal OS_Handle
+os_semaphore_alloc(
+        U32 initial_count)
+{
+    HANDLE semaphore = CreateSemaphoreA(0, (LONG)initial_count, 0x7fffffff, 0);
+    return((OS_Handle){ .u64 = { IntFromPtr(semaphore) } });
+}
+
+internal void
+os_semaphore_release(
+        OS_Handle semaphore)
+{
+    HANDLE s = (HANDLE)PtrFromInt(semaphore.u64[0]);
+    if(s != 0)
+    {
+        CloseHandle(s);
+    }
+}
+
+internal void
+os_semaphore_signal(
+        OS_Handle semaphore,
+        U32 count)
+{
+    ReleaseSemaphore((HANDLE)PtrFromInt(semaphore.u64[0]), (LONG)count, 0);
+}
+
+internal void
+os_semaphore_wait(
+        OS_Handle semaphore)
+{
+    WaitForSingleObject((HANDLE)PtrFromInt(semaphore.u64[0]), INFINITE);
+}
+
+internal U64
+os_now_microseconds(
+        void)
+{
+    U64 result = 0;
+    LARGE_INTEGER counter = {0};
+    if(QueryPerformanceCounter(&counter))
+    {
+        // angn: whole seconds and the remainder apart, counter * 1000000 wraps
+        // after a few weeks of uptime at a 10MHz counter
+        U64 ticks = (U64)counter.QuadPart;
+        U64 frequency = g_os_win32_state.microsecond_resolution;
+        result = (ticks / frequency) * 1000000 + ((ticks % frequency) * 1000000) / frequency;
+    }
+    return(result);
+}
+
+internal void
+os_sleep_milliseconds(
+        U32 msec)
+{
+    Sleep(msec);
+}
+
+internal OS_Handle
+os_file_open(
+        OS_AccessFlags flags,
+        String8 path)
+{
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+
+    DWORD access = 0;
+    DWORD creation = OPEN_EXISTING;
+    if(flags & OS_AccessFlag_Read) { access |= GENERIC_READ; }
+    if(flags & OS_AccessFlag_Write) { access |= GENERIC_WRITE; creation = (flags & OS_AccessFlag_Read) ? OPEN_ALWAYS : CREATE_ALWAYS; }
+
+    OS_Handle result = {0};
+    HANDLE file = CreateFileA(path_cstr, access, FILE_SHARE_READ, 0, creation, FILE_ATTRIBUTE_NORMAL, 0);
+    if(file != INVALID_HANDLE_VALUE)
+    {
+        result.u64[0] = IntFromPtr(file);
+    }
+    return(result);
+}
+
+internal void
+os_file_close(
+        OS_Handle file)
+{
+    if(file.u64[0] != 0)
+    {
+        CloseHandle((HANDLE)PtrFromInt(file.u64[0]));
+    }
+}
+
+internal U64
+os_file_size(
+        OS_Handle file)
+{
+    U64 result = 0;
+    LARGE_INTEGER size = {0};
+    if(file.u64[0] != 0 && GetFileSizeEx((HANDLE)PtrFromInt(file.u64[0]), &size))
+    {
+        result = (U64)size.QuadPart;
+    }
+    return(result);
+}
+
+internal U64
+os_file_read(
+        OS_Handle file,
+        U64 offset,
+        void *out,
+        U64 size)
+{
+    U64 total = 0;
+    if(file.u64[0] != 0)
+    {
+        for(;total < size;)
+        {
+            U64 pos = offset + total;
+            OVERLAPPED overlapped = {0};
+            overlapped.Offset = (DWORD)(pos & 0xffffffff);
+            overlapped.OffsetHigh = (DWORD)(pos >> 32);
+            DWORD to_read = (DWORD)Min(size - total, 0xffffffff);
+            DWORD amount = 0;
+            if(!ReadFile((HANDLE)PtrFromInt(file.u64[0]), (U8 *)out + total, to_read, &amount, &overlapped) || amount == 0) { break; }
+            total += amount;
+        }
+    }
+    return(total);
+}
+
+internal U64
+os_file_write(
+        OS_Handle file,
+        U64 offset,
+        void *data,
+        U64 size)
+{
+    U64 total = 0;
+    if(file.u64[0] != 0)
+    {
+        for(;total < size;)
+        {
+            U64 pos = offset + total;
+            OVERLAPPED overlapped = {0};
+            overlapped.Offset = (DWORD)(pos & 0xffffffff);
+            overlapped.OffsetHigh = (DWORD)(pos >> 32);
+            DWORD to_write = (DWORD)Min(size - total, 0xffffffff);
+            DWORD amount = 0;
+            if(!WriteFile((HANDLE)PtrFromInt(file.u64[0]), (U8 *)data + total, to_write, &amount, &overlapped) || amount == 0) { break; }
+            total += amount;
+        }
+    }
+    return(total);
+}
+
+internal U64
+os_file_modified_time(
+        String8 path)
+{
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+
+    U64 result = 0;
+    WIN32_FILE_ATTRIBUTE_DATA attributes = {0};
+    if(GetFileAttributesExA(path_cstr, GetFileExInfoStandard, &attributes))
+    {
+        result = U64FromTwoU32s(attributes.ftLastWriteTime.dwHighDateTime, attributes.ftLastWriteTime.dwLowDateTime);
+    }
+    return(result);
+}
+
+internal B32
+os_file_delete(
+        String8 path)
+{
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+    return(DeleteFileA(path_cstr) != 0);
+}
+
+internal OS_Handle
+os_library_open(
+        String8 path)
+{
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+    return((OS_Handle){ .u64 = { IntFromPtr(LoadLibraryA(path_cstr)) } });
+}
+
+internal VoidProc *
+os_library_load_proc(
+        OS_Handle library,
+        char *name)
+{
+    VoidProc *result = 0;
+    if(library.u64[0] != 0)
+    {
+        result = (VoidProc *)GetProcAddress((HMODULE)PtrFromInt(library.u64[0]), name);
+    }
+    return(result);
+}
+
+internal void
+os_library_close(
+        OS_Handle library)
+{
+    if(library.u64[0] != 0)
+    {
+        FreeLibrary((HMODULE)PtrFromInt(library.u64[0]));
+    }
+}
+
+internal OS_FileMap
+os_file_map(
+        String8 path)
+{
+    OS_FileMap map = {0};
+
+    char path_cstr[OS_PATH_MAX] = {0};
+    memcpy(path_cstr, path.string, Min(path.size, OS_PATH_MAX - 1));
+
+    HANDLE file = CreateFileA(path_cstr, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if(file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER size = {0};
+        if(GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        {
+            HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+            if(mapping != 0)
+            {
+                void *base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                if(base != 0)
+                {
+                    map.base = base;
+                    map.size = (U64)size.QuadPart;
+                }
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+
+    return(map);
+}
+
+internal void
+os_file_unmap(
+        OS_FileMap map)
+{
+    if(map.base != 0)
+    {
+        UnmapViewOfFile(map.base);
+    }
+}
+
+// angn: TODO: ReadDirectoryChangesW, until then nothing is ever reported
+internal OS_Handle
+os_file_watch_open(
+        void)
+{
+    OS_Handle result = {0};
+    return(result);
+}
+
+internal B32
+os_file_watch_add_directory(
+        OS_Handle handle,
+        String8 path)
+{
+    NotUsed(handle);
+    NotUsed(path);
+    return(0);
+}
+
+internal OS_FileWatchEventList
+os_file_watch_wait(
+        Arena *arena,
+        OS_Handle handle,
+        U32 timeout_msec)
+{
+    NotUsed(arena);
+    NotUsed(handle);
+    OS_FileWatchEventList list = {0};
+    os_sleep_milliseconds(timeout_msec);
+    return(list);
+}
+
 #endif // OS_WINDOWS
 
+// IMPL OS: shared
+internal String8
+os_data_from_file_path(
+        Arena *arena,
+        String8 path)
+{
+    String8 result = {0};
+    OS_Handle file = os_file_open(OS_AccessFlag_Read, path);
+    if(file.u64[0] != 0)
+    {
+        U64 size = os_file_size(file);
+        U8 *data = arena_push_array_no_zero(arena, U8, size + 1);
+        U64 read = os_file_read(file, 0, data, size);
+        if(read == size)
+        {
+            data[size] = 0;
+            result = string8_make(data, size);
+        }
+        else
+        {
+            arena_pop(arena, size + 1);
+        }
+        os_file_close(file);
+    }
+    return(result);
+}
+
+internal B32
+os_write_data_to_file_path(
+        String8 path,
+        String8 data)
+{
+    B32 result = 0;
+    OS_Handle file = os_file_open(OS_AccessFlag_Write, path);
+    if(file.u64[0] != 0)
+    {
+        result = (os_file_write(file, 0, data.string, data.size) == data.size);
+        os_file_close(file);
+    }
+    return(result);
+}
+
 #endif // IMPL_POUNDC_OS
 
 /* ARENA */
@@ -1040,6 +4454,7 @@ arena_make_(
 {
     U64 reserve_size = 0;
     U64 commit_size = 0;
+    Assert(os_get_system_info()->page_size != 0); // angn: os_init has not run in this module
     // align reserve and commit sizes to OS sizes
     if(params->flags & ArenaFlags_LargePages)
     {